@@ -1,4 +1,6 @@
 #include <iostream>
+#include <cstdint>
+#include <cstring>
 
 using namespace std;
 
@@ -10,7 +12,110 @@ struct Node {
     Node(int v) : val(v), next(nullptr) {}
 };
 
-// 2. 哈希表类（拉链法实现）
+// 2. 分块布隆过滤器 (Blocked Bloom Filter)
+// 绝大多数 query 都是查不到的，原来每次都要把整条链走完才能输出 "Not Found"。
+// 在桶前面挡一层布隆过滤器：过滤器说“一定不在”就直接返回，不再碰链表。
+// 普通布隆过滤器的 k 个比特散落在整张位图里，一次查询要 k 次缓存未命中；
+// 这里把一个键的全部比特限制在同一个 64 字节的块（一条 cache line）内，
+// 块内 8 个 64 位字每个只置 1 位，一次查询只探测一条 cache line。
+class BlockedBloom {
+private:
+    struct alignas(64) Block {
+        uint64_t w[8];
+    };
+
+    Block* blocks;
+    uint32_t mask;    // 块数 - 1（块数是 2 的幂，用位与代替取模）
+    int capacity;     // 按每键约 16 bit 设计的容量，超过后 FPR 会明显上升
+
+    // 8 个奇数乘子，把同一个 32 位哈希打散成块内 8 个不同的位置
+    static uint32_t salt(int i) {
+        static const uint32_t SALT[8] = {
+            0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+            0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+        };
+        return SALT[i];
+    }
+
+    // splitmix64 的混合函数：保证相邻整数也能均匀落到不同的块
+    static uint64_t mix(int key) {
+        uint64_t z = (uint64_t)(uint32_t)key + 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    Block& blockOf(uint64_t h) const {
+        return blocks[(uint32_t)(h >> 32) & mask];
+    }
+
+public:
+    // 预计存放 expectedKeys 个键时的块数：每块 32 个键（每键 16 bit），向上取 2 的幂
+    static uint32_t blocksFor(int expectedKeys) {
+        uint32_t need = (uint32_t)(expectedKeys / 32 + 1);
+        uint32_t n = 1;
+        while (n < need) n <<= 1;
+        return n;
+    }
+
+    static int capacityFor(int expectedKeys) { return (int)(blocksFor(expectedKeys) * 32); }
+
+    // expectedKeys: 预计存放的键数
+    explicit BlockedBloom(int expectedKeys) {
+        uint32_t n = blocksFor(expectedKeys);
+        blocks = new Block[n];
+        mask = n - 1;
+        capacity = (int)(n * 32);
+        clear();
+    }
+
+    ~BlockedBloom() {
+        delete[] blocks;
+    }
+
+    void clear() {
+        memset(blocks, 0, sizeof(Block) * (mask + 1));
+    }
+
+    int getCapacity() const { return capacity; }
+
+    void add(int key) {
+        uint64_t h = mix(key);
+        Block& b = blockOf(h);
+        uint32_t lo = (uint32_t)h;
+        for (int i = 0; i < 8; ++i) {
+            b.w[i] |= 1ULL << ((lo * salt(i)) >> 26);
+        }
+    }
+
+    // 返回 false 表示一定不存在；返回 true 表示“可能存在”，需要再查链表
+    bool mayContain(int key) const {
+        uint64_t h = mix(key);
+        const Block& b = blockOf(h);
+        uint32_t lo = (uint32_t)h;
+        uint64_t miss = 0;
+        for (int i = 0; i < 8; ++i) {
+            miss |= ~b.w[i] & (1ULL << ((lo * salt(i)) >> 26));
+        }
+        return miss == 0;
+    }
+
+    // 根据当前位图的填充情况估算理论误判率：
+    // 一个不存在的键被误判，需要它在所选块的 8 个字里命中的位都恰好为 1
+    double estimatedFpr() const {
+        double total = 0;
+        for (uint32_t i = 0; i <= mask; ++i) {
+            double p = 1.0;
+            for (int j = 0; j < 8; ++j) {
+                p *= __builtin_popcountll(blocks[i].w[j]) / 64.0;
+            }
+            total += p;
+        }
+        return total / (mask + 1);
+    }
+};
+
+// 3. 哈希表类（拉链法实现）
 class LinkedHashTable {
 private:
     // 桶结构：包含头指针和链表当前长度
@@ -29,13 +134,72 @@ private:
     Bucket* buckets; // 桶数组
     int D;           // 除数
 
+    // 布隆过滤器前置层（可选，nullptr 表示关闭）
+    // 标准布隆过滤器不支持删除：删除后过滤器里残留的比特只会让误判率上升，
+    // 不会导致漏判，所以删除时不动过滤器，等删除次数累积到一定程度再整体重建。
+    BlockedBloom* bloom;
+    int liveCount;            // 当前表中的元素个数
+    int deletesSinceRebuild;  // 上次重建以来的删除次数
+
+    // 统计信息
+    long long bloomRejects;        // 被过滤器直接拦下的查找（省掉的链表遍历）
+    long long bloomFalsePositives; // 过滤器说“可能存在”但链表里没有
+    long long bloomRebuilds;
+
     // 哈希函数：处理负数情况
     int hash(int key) const {
         return (key % D + D) % D;
     }
 
+    // 用链表中现存的元素重建过滤器
+    // 一次重建要扫完 D 个桶、清空至少能容纳 D 个键的位图，代价是 O(D + n) 而不是 O(n)。
+    // 触发条件：删除次数超过 max(n, D) / 4（残留比特太多），或元素个数超过设计容量（需要扩大位图）。
+    // 两次重建之间至少隔了 Ω(max(n, D)) 次操作，重建代价才真正被摊销；
+    // 只按 n 计数的话，D 远大于 n 时几十次删除就重建一次，过滤器反而拖慢整体。
+    // 位图容量至少按 D 个键分配，所以 D / 4 个残留键仍在设计负载之内。
+    void rebuildBloom() {
+        int want = liveCount * 2;
+        if (want < D) want = D;
+        int cap = bloom->getCapacity();
+        bool resize = want > cap || liveCount * 4 < cap;
+        // 算下来新位图与现在一样大就直接清零复用，不必释放再申请
+        if (resize && BlockedBloom::capacityFor(want) != cap) {
+            delete bloom;
+            bloom = new BlockedBloom(want);
+        } else {
+            bloom->clear();
+        }
+        for (int i = 0; i < D; ++i) {
+            for (Node* curr = buckets[i].head; curr != nullptr; curr = curr->next) {
+                bloom->add(curr->val);
+            }
+        }
+        deletesSinceRebuild = 0;
+        bloomRebuilds++;
+    }
+
+    // 过滤器判定 x 一定不存在时返回 true
+    bool definitelyAbsent(int x) {
+        if (bloom == nullptr || bloom->mayContain(x)) return false;
+        bloomRejects++;
+        return true;
+    }
+
 public:
-    LinkedHashTable(int divisor) : D(divisor) {
+    struct Stats {
+        int size;
+        long long bloomRejects;
+        long long bloomFalsePositives;
+        long long bloomRebuilds;
+        double observedFpr;  // 实测误判率 = 误判次数 / 所有查不到的查找次数
+        double estimatedFpr; // 按当前位图填充率估算的理论误判率
+    };
+
+    // useBloom: 是否在桶前启用布隆过滤器（只影响速度，不影响输出）
+    LinkedHashTable(int divisor, bool useBloom = true)
+        : D(divisor), bloom(nullptr), liveCount(0), deletesSinceRebuild(0),
+          bloomRejects(0), bloomFalsePositives(0), bloomRebuilds(0) {
+        if (useBloom) bloom = new BlockedBloom(D);
         buckets = new Bucket[D];
         for (int i = 0; i < D; ++i) {
             buckets[i].head = nullptr;
@@ -59,20 +223,24 @@ public:
             }
         }
         delete[] buckets;
+        delete bloom;
     }
 
     // 插入操作 (opt 0)
     void insert(int x) {
         int idx = hash(x);
         
-        // 1. 检查是否存在
-        Node* curr = buckets[idx].head;
-        while (curr != nullptr) {
-            if (curr->val == x) {
-                cout << "Existed" << endl;
-                return;
+        // 1. 检查是否存在（过滤器判定不存在时可以跳过整条链）
+        if (!definitelyAbsent(x)) {
+            Node* curr = buckets[idx].head;
+            while (curr != nullptr) {
+                if (curr->val == x) {
+                    cout << "Existed" << endl;
+                    return;
+                }
+                curr = curr->next;
             }
-            curr = curr->next;
+            if (bloom != nullptr) bloomFalsePositives++;
         }
 
         // 2. 头插法插入新节点 (效率 O(1))
@@ -80,11 +248,20 @@ public:
         newNode->next = buckets[idx].head;
         buckets[idx].head = newNode;
         buckets[idx].length++;
+        liveCount++;
+        if (bloom != nullptr) {
+            if (liveCount > bloom->getCapacity()) rebuildBloom();
+            else bloom->add(x);
+        }
         // 题目未要求插入成功后输出，保持静默
     }
 
     // 查询操作 (opt 1)
     void query(int x) {
+        if (definitelyAbsent(x)) {
+            cout << "Not Found" << endl;
+            return;
+        }
         int idx = hash(x);
         
         Node* curr = buckets[idx].head;
@@ -97,11 +274,16 @@ public:
             curr = curr->next;
             //保持循环能够继续
         }
+        if (bloom != nullptr) bloomFalsePositives++;
         cout << "Not Found" << endl;
     }
 
     // 删除操作 (opt 2)
     void remove(int x) {
+        if (definitelyAbsent(x)) {
+            cout << "Delete Failed" << endl;
+            return;
+        }
         int idx = hash(x);
         
         Node* curr = buckets[idx].head;
@@ -120,27 +302,54 @@ public:
                 
                 delete curr;
                 buckets[idx].length--;
+                liveCount--;
                 
                 // 题目要求：输出删除后链表的长度
                 cout << buckets[idx].length << endl;
+
+                if (bloom != nullptr && ++deletesSinceRebuild > (liveCount > D ? liveCount : D) / 4 + 64) {
+                    rebuildBloom();
+                }
                 return;
             }
             // 继续遍历
             prev = curr;
             curr = curr->next;
         }
+        if (bloom != nullptr) bloomFalsePositives++;
         cout << "Delete Failed" << endl;
     }
+
+    Stats stats() const {
+        Stats st;
+        st.size = liveCount;
+        st.bloomRejects = bloomRejects;
+        st.bloomFalsePositives = bloomFalsePositives;
+        st.bloomRebuilds = bloomRebuilds;
+        long long negatives = bloomRejects + bloomFalsePositives;
+        st.observedFpr = negatives ? (double)bloomFalsePositives / negatives : 0.0;
+        st.estimatedFpr = bloom ? bloom->estimatedFpr() : 0.0;
+        return st;
+    }
 };
 
-int main() {
+// 命令行参数（均可省略，不影响标准输出）：
+//   --no-bloom  关闭布隆过滤器
+//   --stats     结束后把过滤器统计信息输出到 stderr
+int main(int argc, char* argv[]) {
     // 优化 I/O
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
 
+    bool useBloom = true, showStats = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--no-bloom") == 0) useBloom = false;
+        else if (strcmp(argv[i], "--stats") == 0) showStats = true;
+    }
+
     int D, m;
     if (cin >> D >> m) {
-        LinkedHashTable ht(D);
+        LinkedHashTable ht(D, useBloom);
         for (int i = 0; i < m; ++i) {
             int opt, x;
             cin >> opt >> x;
@@ -152,6 +361,15 @@ int main() {
                 ht.remove(x);
             }
         }
+        if (showStats) {
+            LinkedHashTable::Stats st = ht.stats();
+            cerr << "size=" << st.size
+                 << " bloom_rejects=" << st.bloomRejects
+                 << " false_positives=" << st.bloomFalsePositives
+                 << " rebuilds=" << st.bloomRebuilds
+                 << " observed_fpr=" << st.observedFpr
+                 << " estimated_fpr=" << st.estimatedFpr << endl;
+        }
     }
     return 0;
 }
\ No newline at end of file
@@ -1,299 +1,1026 @@
 #include <iostream>
 #include <cstdio> // 使用 scanf/printf，处理大数据量时比 cin/cout 快很多
+#include <cstring>
+#include <cstdlib>
+#include <climits>
 
 using namespace std;
 
+// -------------------- 平衡策略（编译期选择） --------------------
+// 普通 BST 在有序/近似有序插入下退化成链表，insert/search/searchByRank 都变成 O(n)，
+// m = 10^6 时递归深度也会把栈撑爆。这里提供三种自平衡方式，都保留 size 域，
+// 因此按名次操作依旧是 O(log n)。编译时用 -DBST_BALANCE=<n> 选择：
+//   0 BST_PLAIN  不平衡（兼容模式）：树形与原题完全一致，xor_path 输出与原题相同
+//   1 BST_TREAP  Treap：随机优先级 + 旋转，期望深度 O(log n)
+//   2 BST_AVL    AVL 树：严格高度平衡（默认）
+//   3 BST_WBT    重量平衡树 (Weight-Balanced Tree)：直接用 size 判断平衡，不需要额外字段
+// 注意：平衡模式下树形不同，比较路径也不同，xor_path 的输出会和兼容模式不一样。
+#define BST_PLAIN 0
+#define BST_TREAP 1
+#define BST_AVL   2
+#define BST_WBT   3
+
+#ifndef BST_BALANCE
+#define BST_BALANCE BST_AVL
+#endif
+
 // -------------------- 数据结构定义 --------------------
 
 // 定义树节点结构体
+// 孩子用 32 位下标代替 64 位指针：Node 从 32 字节缩到 20 字节，
+// 同样大小的缓存能装下多 60% 的节点
 struct Node {
     int val;        // 节点存储的数值
     int size;       // 以该节点为根的子树的总节点数（用于计算排名 Rank）
-    Node *left;     // 左孩子指针
-    Node *right;    // 右孩子指针
+    int aux;        // 平衡信息：Treap 存优先级，AVL 存子树高度，其余模式不用
+    int left;       // 左孩子在内存池中的下标，NIL 表示空
+    int right;      // 右孩子在内存池中的下标；节点空闲时 left 兼作空闲链表的 next
 };
 
 // -------------------- 内存池 (Memory Pool) --------------------
 // 题目数据量 m <= 1,000,000，频繁使用 new/delete 会非常慢且容易产生内存碎片导致超时。
-// 这里使用静态数组模拟内存分配，称为“内存池”。
-
-const int MAXN = 1000005; // 最大节点数，稍微开大一点防止溢出
-Node pool[MAXN];          // 预先分配好的节点数组
-int pool_ptr = 0;         // 当前已使用的节点下标指针
-
-// 辅助函数：从内存池中分配一个新节点
-// 相当于替代了 new Node(v)
-Node* newNode(int v) {
-    pool_ptr++; // 指针后移，占用一个新的位置
-    pool[pool_ptr].val = v;
-    pool[pool_ptr].size = 1;       // 新节点初始大小为 1（它自己）
-    pool[pool_ptr].left = nullptr; // 初始无左右孩子
-    pool[pool_ptr].right = nullptr;
-    return &pool[pool_ptr];        // 返回该节点的地址
-}
+// 这里自己管理节点内存，称为“内存池”。
+// 最初的版本是固定大小的静态数组 + 只增不减的 pool_ptr：删除的节点永远不会被复用，
+// 长时间运行、插删交替时，累计插入次数一到 MAXN 就越界，与当前存活节点数无关。
+// 现在的做法：
+//   1. 按块 (chunk) 增长：每块 2^16 个节点，不够时再申请一块，不需要预估上限；
+//      已分配的块不会搬家，所以指向节点的引用在扩容后依然有效
+//   2. 空闲链表 (free list)：删除的节点挂回链表（复用 left 字段串联），下次分配优先复用
+//   3. 下标 0 是哨兵空节点 NIL：size = 0、高度 = 0，访问孩子时不必再判空
 
-// -------------------- 全局状态变量 --------------------
+const int NIL = 0;
+const int CHUNK_BITS = 16;
+const int CHUNK_SIZE = 1 << CHUNK_BITS;
 
-// 用于记录单次操作中，路径上经过的节点值的异或和
-// 题目要求：输出执行操作过程中依次比较的元素值的异或值。
-int xor_path = 0;
+struct NodePool {
+    Node** chunks;   // 块指针数组
+    int chunkCount;  // 已申请的块数
+    int chunkCap;    // 块指针数组的容量
+    int used;        // 已经切分出去的最大下标（bump 指针）
+    int freeHead;    // 空闲链表头
 
-// 标记操作是否成功
-// 例如：插入重复值算失败，查找不存在的值算失败
-bool success_flag = false;
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
 
-// -------------------- 核心辅助函数 --------------------
+    NodePool() : chunks(nullptr), chunkCount(0), chunkCap(0), used(0), freeHead(NIL) {
+        grow();
+        Node& nil = chunks[0][0];
+        nil.val = 0;
+        nil.size = 0;
+        // Treap 中空节点的优先级要低于一切真实节点；AVL 中空树高度为 0
+        nil.aux = (BST_BALANCE == BST_TREAP) ? -1 : 0;
+        nil.left = nil.right = NIL;
+    }
 
-// 向上更新节点的大小信息 (Maintain Size)
-// 当子树发生插入或删除后，必须调用此函数更新当前节点的 size
-void pushUp(Node* p) {
-    if (!p) return; // 空节点不需要更新
-    int ls = (p->left) ? p->left->size : 0;   // 左子树大小
-    int rs = (p->right) ? p->right->size : 0; // 右子树大小
-    p->size = ls + rs + 1; // 当前大小 = 左 + 右 + 自身(1)
-}
+    ~NodePool() {
+        for (int i = 0; i < chunkCount; ++i) delete[] chunks[i];
+        delete[] chunks;
+    }
 
-// -------------------- 业务逻辑函数 --------------------
-
-// 【操作 0】插入数值 (Insert)
-// 参数 p: 当前节点指针的引用（引用允许我们修改指针指向）
-// 参数 val: 要插入的值
-void insert(Node* &p, int val) {
-    // 1. 如果当前位置为空，说明找到了插入位置
-    if (p == nullptr) {
-        p = newNode(val);   // 创建新节点
-        success_flag = true; // 标记插入成功
-        // 注意：插入新节点本身不涉及“与该位置原有值的比较”（因为原位置是空），
-        // 且题目样例暗示插入第一个数输出0，所以这里不更新 xor_path
-        return;
-    }
-
-    // 2. 记录路径异或值
-    // 只要进入这个节点进行比较，就需要异或它的值
-    xor_path ^= p->val;
-
-    // 3. 递归查找插入位置
-    if (val == p->val) {
-        // 题目隐含规则：BST通常不存重复值
-        // 如果已存在，标记失败，后续主函数会输出 0
-        success_flag = false; 
-        return;
-    } else if (val < p->val) {
-        insert(p->left, val); // 比当前小，往左插
-    } else {
-        insert(p->right, val); // 比当前大，往右插
+    Node& operator[](int i) {
+        return chunks[i >> CHUNK_BITS][i & (CHUNK_SIZE - 1)];
     }
 
-    // 4. 回溯更新
-    // 如果插入成功了，路径上的节点 size 都要 +1
-    if (success_flag) pushUp(p);
-}
+    // 再申请一块节点；块指针数组满了就倍增
+    void grow() {
+        if (chunkCount == chunkCap) {
+            int newCap = chunkCap ? chunkCap * 2 : 16;
+            Node** bigger = new Node*[newCap];
+            if (chunkCount) memcpy(bigger, chunks, sizeof(Node*) * chunkCount);
+            delete[] chunks;
+            chunks = bigger;
+            chunkCap = newCap;
+        }
+        chunks[chunkCount++] = new Node[CHUNK_SIZE];
+    }
 
-// 【操作 1】查找数值 (Search)
-void search(Node* p, int val) {
-    // 1. 走到空节点，说明没找到
-    if (p == nullptr) {
-        success_flag = false;
-        return;
+    int alloc() {
+        if (freeHead != NIL) { // 优先复用被删除的节点
+            int id = freeHead;
+            freeHead = (*this)[id].left;
+            return id;
+        }
+        if (++used == chunkCount * CHUNK_SIZE) grow();
+        return used;
     }
 
-    // 2. 题目要求：待查询的元素也需要异或入答案中
-    // 只要访问该节点，就计入异或路径
-    xor_path ^= p->val;
+    void release(int id) {
+        (*this)[id].left = freeHead;
+        freeHead = id;
+    }
 
-    // 3. 比较逻辑
-    if (val == p->val) {
-        success_flag = true; // 找到了
-        return;
-    } else if (val < p->val) {
-        search(p->left, val);
-    } else {
-        search(p->right, val);
+    // 一次性回收全部节点（保留已申请的块），用于整体重建
+    void clear() {
+        used = 0;
+        freeHead = NIL;
     }
-}
+};
 
-// -------------------- 删除相关的复杂逻辑 --------------------
-
-// 辅助函数：找到并移除子树中的最小值节点
-// 作用：用于双子节点删除时的“后继替换”策略
-// 注意：题目特别说明“删除操作的替换过程中所有比较操作不计入答案”
-// 所以这个函数里没有 xor_path 的操作
-int removeMin(Node* &p) {
-    // 一直往左走，直到没有左孩子，这就是最小值
-    if (p->left == nullptr) {
-        int minVal = p->val; // 记录下这个最小值
-        p = p->right;        // 用它的右孩子顶替它的位置（断开连接）
-        // 这里不需要 pushUp，因为 p 指针已经变了，上一层回溯时会更新 size
-        return minVal;       // 返回最小值给上层使用
-    }
-    // 递归向左找
-    int val = removeMin(p->left);
-    pushUp(p); // 回溯时更新 size
-    return val;
-}
 
-// 辅助函数：执行节点的物理删除
-// 当我们在 remove 函数中找到了要删除的节点 p 时，调用此函数进行拓扑结构调整
-void deleteNodeDetails(Node* &p) {
-    // 情况1：叶子节点（无孩子）
-    if (!p->left && !p->right) {
-        p = nullptr; // 直接变为空
-    }
-    // 情况2：只有左孩子
-    else if (!p->left) {
-        p = p->right; // 右孩子上位
-    }
-    // 情况3：只有右孩子
-    else if (!p->right) {
-        p = p->left; // 左孩子上位
-    }
-    // 情况4：有两个孩子 (最复杂的情况)
-    else {
-        // 题目明确要求：如果有两个孩子，替换为“右子树中最小的”
-        // removeMin 负责把右子树最小的节点挖出来，并返回其值
-        int minVal = removeMin(p->right);
-        p->val = minVal; // 将当前节点的值替换为后继值
-        // 树结构变了（右子树少了一个节点），更新当前节点大小
+// -------------------- 操作结果 --------------------
+
+// 最初的版本通过全局变量 xor_path / success_flag 传递结果，所有函数都是递归的，
+// 同一进程里只能有一棵树、只能有一个线程在用。
+// 现在每个操作直接返回结果结构体，树的全部状态都在 RankTree 对象内部：
+// 不同的 RankTree 实例互不共享任何数据，可以分别交给不同的线程（不同的核）并行使用。
+struct OpResult {
+    bool ok;     // 操作是否成功：插入重复值、查找/删除不存在的值、名次越界都算失败
+    int xorPath; // 题目要求：执行操作过程中依次比较的元素值的异或值
+};
+
+// -------------------- 排名树引擎 --------------------
+
+class RankTree {
+private:
+    NodePool pool;
+    int root;
+    unsigned int randState; // Treap 的优先级来源：xorshift32 伪随机数，比 rand() 快且周期足够长
+
+    // 下降路径：记录经过的每个“链接槽”（root 或某个节点的 left/right 字段）的地址。
+    // 回溯阶段从最深处往上，对每个槽调用 maintain 即可更新 size 并恢复平衡，
+    // 效果与递归版本在回溯时逐层 maintain 完全相同，但不占用调用栈。
+    // 节点所在的块不会搬家，所以这些地址在整个操作期间一直有效。
+    // 不平衡模式下路径可能长达 n，因此缓冲区按需倍增，放在堆上。
+    int** path;
+    int pathLen;
+    int pathCap;
+
+    // 整型缓冲区（同样按需倍增）：split 记录下降经过的节点，释放子树时当作栈
+    int* buf;
+    int bufLen;
+    int bufCap;
+
+    int nextPriority() {
+        randState ^= randState << 13;
+        randState ^= randState >> 17;
+        randState ^= randState << 5;
+        return (int)(randState >> 1);
+    }
+
+    // 从内存池中分配一个新节点，返回节点下标
+    int newNode(int v) {
+        int id = pool.alloc();
+        Node& nd = pool[id];
+        nd.val = v;
+        nd.size = 1;       // 新节点初始大小为 1（它自己）
+#if BST_BALANCE == BST_TREAP
+        nd.aux = nextPriority();
+#else
+        nd.aux = 1;        // AVL：叶子高度为 1
+#endif
+        nd.left = NIL;     // 初始无左右孩子
+        nd.right = NIL;
+        return id;
+    }
+
+    void pushPath(int* slot) {
+        if (pathLen == pathCap) {
+            int newCap = pathCap * 2;
+            int** bigger = new int*[newCap];
+            memcpy(bigger, path, sizeof(int*) * pathLen);
+            delete[] path;
+            path = bigger;
+            pathCap = newCap;
+        }
+        path[pathLen++] = slot;
+    }
+
+    // 自底向上维护路径上的所有节点
+    void fixPath() {
+        while (pathLen > 0) maintain(*path[--pathLen]);
+    }
+
+    void pushBuf(int v) {
+        if (bufLen == bufCap) {
+            int newCap = bufCap * 2;
+            int* bigger = new int[newCap];
+            memcpy(bigger, buf, sizeof(int) * bufLen);
+            delete[] buf;
+            buf = bigger;
+            bufCap = newCap;
+        }
+        buf[bufLen++] = v;
+    }
+
+    // 二进制位数：按中点对半建出的 s 个节点的树，高度恰好是 bitLength(s)
+    static int bitLength(int s) {
+        return 32 - __builtin_clz((unsigned int)s);
+    }
+
+#if BST_BALANCE == BST_TREAP
+    // 批量建树时 Treap 的优先级：必须满足堆序，同时不能比后续随机插入的节点“整体偏高或偏低”。
+    // 做法：把 n 个节点按层序 (BFS) 编号，第 depth 层占据编号 [2^depth - 1, 2^(depth+1) - 1)，
+    // 编号越小优先级越高，相当于 n 个均匀随机优先级排好序后按层序发下去。
+    // 层内再随机取一个编号，父节点的编号一定小于孩子，堆序自然成立。
+    int bulkPriority(int depth, int n) {
+        long long width = 1LL << depth;
+        long long pos = width - 1 + nextPriority() % width;
+        if (pos > n - 1) pos = n - 1;
+        return (int)((double)(n - pos) / n * 2147483646.0);
+    }
+#endif
+
+    // 向上更新节点的大小信息 (Maintain Size)
+    // 当子树发生插入或删除后，必须调用此函数更新当前节点的 size
+    void pushUp(int p) {
+        if (p == NIL) return; // 空节点不需要更新
+        Node& nd = pool[p];
+        // 哨兵 NIL 的 size 为 0，不用再判断孩子是否为空
+        nd.size = pool[nd.left].size + pool[nd.right].size + 1; // 当前大小 = 左 + 右 + 自身(1)
+#if BST_BALANCE == BST_AVL
+        int lh = pool[nd.left].aux;
+        int rh = pool[nd.right].aux;
+        nd.aux = (lh > rh ? lh : rh) + 1;
+#endif
+    }
+
+    /*
+     * 右旋（左旋与之对称）：
+     *       p             l
+     *      / \           / \
+     *     l   c   ->    a   p
+     *    / \               / \
+     *   a   b             b   c
+     */
+    void rotateRight(int &p) {
+        int l = pool[p].left;
+        pool[p].left = pool[l].right;
+        pool[l].right = p;
+        pushUp(p); // 先更新下沉的 p，再更新新的根 l
+        pushUp(l);
+        p = l;
+    }
+
+    void rotateLeft(int &p) {
+        int r = pool[p].right;
+        pool[p].right = pool[r].left;
+        pool[r].left = p;
         pushUp(p);
+        pushUp(r);
+        p = r;
     }
-}
 
-// 【操作 2】删除数值 (Delete by Value)
-void remove(Node* &p, int val) {
-    if (p == nullptr) {
-        success_flag = false; // 没找到要删的数
-        return;
+#if BST_BALANCE == BST_AVL
+    int heightOf(int p) { return pool[p].aux; }
+#elif BST_BALANCE == BST_WBT
+    // 重量 = size + 1，空树重量为 1，参数取 Hirai & Yamamoto 证明正确的 <3, 2>
+    static const int WBT_DELTA = 3;
+    static const int WBT_GAMMA = 2;
+    int weightOf(int p) { return pool[p].size + 1; }
+#endif
+
+    // 回溯时维护当前节点：更新 size（及高度），必要时旋转恢复平衡
+    // 兼容模式下就是 pushUp，树形与原来完全一致
+    // 插入/删除每次只改变一条路径，所以在路径上每一层调用一次就足够恢复整棵树的平衡
+    void maintain(int &p) {
+        if (p == NIL) return;
+#if BST_BALANCE == BST_TREAP
+        // 插入后只有刚走过的那个孩子可能优先级比父亲高，把它转上来
+        // 删除采用“后继值替换 + 摘除单孩子节点”，不会破坏堆序，这里不会触发旋转
+        if (pool[pool[p].left].aux > pool[p].aux) rotateRight(p);
+        else if (pool[pool[p].right].aux > pool[p].aux) rotateLeft(p);
+        else pushUp(p);
+#elif BST_BALANCE == BST_AVL
+        int l = pool[p].left, r = pool[p].right;
+        int diff = heightOf(l) - heightOf(r);
+        if (diff > 1) {
+            // 左高：LR 型先把左孩子左旋成 LL 型
+            if (heightOf(pool[l].left) < heightOf(pool[l].right)) rotateLeft(pool[p].left);
+            rotateRight(p);
+        } else if (diff < -1) {
+            if (heightOf(pool[r].right) < heightOf(pool[r].left)) rotateRight(pool[p].right);
+            rotateLeft(p);
+        } else {
+            pushUp(p);
+        }
+#elif BST_BALANCE == BST_WBT
+        pushUp(p);
+        int l = pool[p].left, r = pool[p].right;
+        if (WBT_DELTA * weightOf(l) < weightOf(r)) {
+            // 右重：右孩子的内侧子树太重时需要双旋
+            if (weightOf(pool[r].left) >= WBT_GAMMA * weightOf(pool[r].right)) rotateRight(pool[p].right);
+            rotateLeft(p);
+        } else if (WBT_DELTA * weightOf(r) < weightOf(l)) {
+            if (weightOf(pool[l].right) >= WBT_GAMMA * weightOf(pool[l].left)) rotateLeft(pool[p].left);
+            rotateRight(p);
+        }
+#else
+        pushUp(p);
+#endif
     }
 
-    xor_path ^= p->val; // 计入路径
+    // 物理删除槽 slot 上的节点，调用前 path 中是它的全部祖先
+    // 注意：题目特别说明“删除操作的替换过程中所有比较操作不计入答案”，
+    // 所以这里寻找后继时不更新 xorPath
+    void deleteAt(int* slot) {
+        int old = *slot;
+        int l = pool[old].left, r = pool[old].right;
+        if (l == NIL || r == NIL) {
+            // 叶子或只有一个孩子：唯一的孩子（或 NIL）直接上位
+            *slot = (l == NIL) ? r : l;
+            pool.release(old);
+        } else {
+            // 有两个孩子：题目要求替换为“右子树中最小的”
+            // 当前节点保留（只换值），沿右子树的左链找到最小节点并摘下，
+            // 左链上的节点和当前节点都要在回溯时更新 size
+            pushPath(slot);
+            int* m = &pool[old].right;
+            while (pool[*m].left != NIL) {
+                pushPath(m);
+                m = &pool[*m].left;
+            }
+            int minNode = *m;
+            pool[old].val = pool[minNode].val; // 将当前节点的值替换为后继值
+            *m = pool[minNode].right;          // 用后继的右孩子顶替它的位置
+            pool.release(minNode);
+        }
+        fixPath();
+    }
 
-    if (val == p->val) {
-        success_flag = true;
-        deleteNodeDetails(p); // 找到目标，执行物理删除
-        return;
-    } else if (val < p->val) {
-        remove(p->left, val);
-    } else {
-        remove(p->right, val);
+    // ---------- split / join 的基础操作 ----------
+
+    // join3：已知 l 中所有键 < m 的值 < r 中所有键，把三者拼成一棵平衡树，返回新根。
+    // 平衡模式下沿较“重”一侧的内侧边界往下走，找到与另一侧平衡的位置挂上 m，
+    // 再沿这条路径往回 maintain —— 与插入后的回溯是同一套逻辑，代价 O(两树高度差)。
+    int join3(int l, int m, int r) {
+        int t = NIL;
+        int* slot = &t;
+        pathLen = 0;
+#if BST_BALANCE == BST_AVL
+        int hl = heightOf(l), hr = heightOf(r);
+        if (hl > hr + 1) {
+            t = l;
+            while (heightOf(*slot) > hr + 1) {
+                pushPath(slot);
+                slot = &pool[*slot].right;
+            }
+            l = *slot;
+        } else if (hr > hl + 1) {
+            t = r;
+            while (heightOf(*slot) > hl + 1) {
+                pushPath(slot);
+                slot = &pool[*slot].left;
+            }
+            r = *slot;
+        }
+#elif BST_BALANCE == BST_WBT
+        if (WBT_DELTA * weightOf(r) < weightOf(l)) {
+            t = l;
+            while (WBT_DELTA * weightOf(r) < weightOf(*slot)) {
+                pushPath(slot);
+                slot = &pool[*slot].right;
+            }
+            l = *slot;
+        } else if (WBT_DELTA * weightOf(l) < weightOf(r)) {
+            t = r;
+            while (WBT_DELTA * weightOf(l) < weightOf(*slot)) {
+                pushPath(slot);
+                slot = &pool[*slot].left;
+            }
+            r = *slot;
+        }
+#elif BST_BALANCE == BST_TREAP
+        // 按优先级归并两侧的内侧边界，直到 m 的优先级比两侧的根都高
+        while (pool[l].aux > pool[m].aux || pool[r].aux > pool[m].aux) {
+            if (pool[l].aux > pool[r].aux) {
+                *slot = l;
+                pushPath(slot);
+                slot = &pool[l].right;
+                l = pool[l].right;
+            } else {
+                *slot = r;
+                pushPath(slot);
+                slot = &pool[r].left;
+                r = pool[r].left;
+            }
+        }
+#endif
+        pool[m].left = l;
+        pool[m].right = r;
+        pushUp(m);
+        *slot = m;
+        fixPath();
+        return t;
     }
 
-    // 回溯更新 size
-    if (success_flag && p) pushUp(p);
-}
+    // 摘下树 t 的最小节点（不释放），返回其下标
+    int popMin(int &t) {
+        pathLen = 0;
+        int* slot = &t;
+        while (pool[*slot].left != NIL) {
+            pushPath(slot);
+            slot = &pool[*slot].left;
+        }
+        int minNode = *slot;
+        *slot = pool[minNode].right;
+        fixPath();
+        return minNode;
+    }
 
-// 【操作 3】按名次查找 (Search by Rank)
-// k: 第 k 小的数
-void searchByRank(Node* p, int k) {
-    if (p == nullptr) {
-        success_flag = false;
-        return;
-    }
-
-    xor_path ^= p->val; // 计入路径
-
-    // 当前节点的左子树大小
-    int leftSize = (p->left) ? p->left->size : 0;
-    
-    // 判断 k 落在哪一边
-    // 当前节点的排名是 leftSize + 1
-    if (k == leftSize + 1) {
-        success_flag = true; // 找到了
-        return;
-    } else if (k <= leftSize) {
-        // 目标在左子树，名次 k 不变
-        searchByRank(p->left, k);
-    } else {
-        // 目标在右子树
-        // 在右子树中的新名次 = 原名次 - (左子树数量 + 根节点自己)
-        searchByRank(p->right, k - leftSize - 1);
+    // join2：l 中所有键 < r 中所有键，借用 r 的最小节点作为 join3 的中间节点
+    int join2(int l, int r) {
+        if (l == NIL) return r;
+        if (r == NIL) return l;
+        int m = popMin(r);
+        return join3(l, m, r);
     }
-}
 
-// 【操作 4】按名次删除 (Delete by Rank)
-void removeByRank(Node* &p, int k) {
-    if (p == nullptr) {
-        success_flag = false;
-        return;
+    // 把树 t 拆成两棵：l 含所有 < key（inclusive 时 <= key）的键，r 含其余的键。
+    // 先沿 key 下降记录经过的节点，再自底向上用 join3 把每个节点和它“留下”的那棵子树
+    // 拼到对应一侧 —— 递归 split 的迭代展开。平衡模式下总代价 O(log n)。
+    void split(int t, int key, bool inclusive, int &l, int &r) {
+        bufLen = 0;
+        while (t != NIL) {
+            pushBuf(t);
+            int v = pool[t].val;
+            bool toLeft = inclusive ? (v <= key) : (v < key);
+            t = toLeft ? pool[t].right : pool[t].left;
+        }
+        l = r = NIL;
+        for (int i = bufLen - 1; i >= 0; --i) {
+            int p = buf[i];
+            int v = pool[p].val;
+            bool toLeft = inclusive ? (v <= key) : (v < key);
+            if (toLeft) l = join3(pool[p].left, p, l);
+            else r = join3(r, p, pool[p].right);
+        }
     }
 
-    xor_path ^= p->val; // 计入路径
+    // 把整棵子树的节点还给内存池
+    void releaseTree(int t) {
+        bufLen = 0;
+        if (t != NIL) pushBuf(t);
+        while (bufLen > 0) {
+            int p = buf[--bufLen];
+            if (pool[p].left != NIL) pushBuf(pool[p].left);
+            if (pool[p].right != NIL) pushBuf(pool[p].right);
+            pool.release(p); // release 会改写 left，必须先把孩子压栈
+        }
+    }
 
-    int leftSize = (p->left) ? p->left->size : 0;
+    int minVal(int t) {
+        while (pool[t].left != NIL) t = pool[t].left;
+        return pool[t].val;
+    }
 
-    if (k == leftSize + 1) {
-        success_flag = true;
-        deleteNodeDetails(p); // 找到目标，直接删除
-        return;
-    } else if (k <= leftSize) {
-        removeByRank(p->left, k);
-    } else {
-        removeByRank(p->right, k - leftSize - 1);
+    int maxVal(int t) {
+        while (pool[t].right != NIL) t = pool[t].right;
+        return pool[t].val;
     }
 
-    if (success_flag && p) pushUp(p);
-}
+public:
+    RankTree() : root(NIL), randState(2463534242u), pathLen(0), pathCap(64), bufLen(0), bufCap(64) {
+        path = new int*[pathCap];
+        buf = new int[bufCap];
+    }
+
+    ~RankTree() {
+        delete[] path;
+        delete[] buf;
+    }
+
+    RankTree(const RankTree&) = delete;
+    RankTree& operator=(const RankTree&) = delete;
+
+    int size() { return pool[root].size; }
+
+    // 【操作 0】插入数值 (Insert)
+    OpResult insert(int val) {
+        OpResult res = {false, 0};
+        int* slot = &root;
+        pathLen = 0;
+        while (*slot != NIL) {
+            Node& nd = pool[*slot];
+            // 只要进入这个节点进行比较，就需要异或它的值
+            res.xorPath ^= nd.val;
+            // 题目隐含规则：BST 不存重复值，已存在算失败
+            if (val == nd.val) return res;
+            pushPath(slot);
+            slot = (val < nd.val) ? &nd.left : &nd.right; // 比当前小往左，否则往右
+        }
+        // 找到了空位。插入新节点本身不涉及“与该位置原有值的比较”，
+        // 且题目样例暗示插入第一个数输出 0，所以这里不更新 xorPath
+        int id = newNode(val);
+        *slot = id;
+        // 路径上的节点 size 都要 +1，平衡模式下顺便旋转恢复平衡
+        fixPath();
+        res.ok = true;
+        return res;
+    }
+
+    // 【操作 1】查找数值 (Search)
+    // 题目要求：待查询的元素也需要异或入答案中
+    OpResult search(int val) {
+        OpResult res = {false, 0};
+        int p = root;
+        while (p != NIL) {
+            Node& nd = pool[p];
+            res.xorPath ^= nd.val;
+            if (val == nd.val) {
+                res.ok = true;
+                return res;
+            }
+            p = (val < nd.val) ? nd.left : nd.right;
+        }
+        return res;
+    }
+
+    // 【操作 2】删除数值 (Delete by Value)
+    OpResult remove(int val) {
+        OpResult res = {false, 0};
+        int* slot = &root;
+        pathLen = 0;
+        while (*slot != NIL) {
+            Node& nd = pool[*slot];
+            res.xorPath ^= nd.val; // 计入路径
+            if (val == nd.val) {
+                deleteAt(slot); // 找到目标，执行物理删除
+                res.ok = true;
+                return res;
+            }
+            pushPath(slot);
+            slot = (val < nd.val) ? &nd.left : &nd.right;
+        }
+        return res; // 没找到要删的数
+    }
+
+    // 【操作 3】按名次查找 (Search by Rank)
+    // k: 第 k 小的数
+    OpResult searchByRank(int k) {
+        OpResult res = {false, 0};
+        // 边界检查：如果 k 超过了树的总节点数，显然不存在
+        if (k < 1 || k > size()) return res;
+        int p = root;
+        while (true) {
+            Node& nd = pool[p];
+            res.xorPath ^= nd.val; // 计入路径
+            // 当前节点的排名是 leftSize + 1
+            int leftSize = pool[nd.left].size;
+            if (k == leftSize + 1) break;
+            if (k <= leftSize) {
+                p = nd.left; // 目标在左子树，名次 k 不变
+            } else {
+                // 在右子树中的新名次 = 原名次 - (左子树数量 + 根节点自己)
+                k -= leftSize + 1;
+                p = nd.right;
+            }
+        }
+        res.ok = true;
+        return res;
+    }
+
+    // 【操作 4】按名次删除 (Delete by Rank)
+    OpResult removeByRank(int k) {
+        OpResult res = {false, 0};
+        if (k < 1 || k > size()) return res;
+        int* slot = &root;
+        pathLen = 0;
+        while (true) {
+            Node& nd = pool[*slot];
+            res.xorPath ^= nd.val; // 计入路径
+            int leftSize = pool[nd.left].size;
+            if (k == leftSize + 1) break;
+            pushPath(slot);
+            if (k <= leftSize) {
+                slot = &nd.left;
+            } else {
+                k -= leftSize + 1;
+                slot = &nd.right;
+            }
+        }
+        deleteAt(slot); // 找到目标，直接删除
+        res.ok = true;
+        return res;
+    }
+
+    // -------------------- 批量与区间操作 --------------------
+
+    // 批量建树：从严格递增的数组 a[0..n) 以 O(n) 时间建出完全平衡的树，替换原有内容。
+    // 逐个 insert 在不平衡模式下对有序数据是 O(n^2)，平衡模式下也要 O(n log n) 并伴随大量旋转。
+    // 每个节点取区间中点，size 直接等于区间长度、高度直接由长度算出，不需要回溯；
+    // 节点按先序连续分配，同一棵子树在内存中也是连续的。
+    // 数组不是严格递增时返回 false，树保持不变。
+    bool buildFromSorted(const int* a, int n) {
+        for (int i = 1; i < n; ++i) {
+            if (a[i - 1] >= a[i]) return false;
+        }
+        pool.clear();
+        root = NIL;
+
+        struct Frame {
+            int lo, hi; // 区间 [lo, hi)
+            int depth;
+            int* slot;  // 建好的子树挂到哪里
+        };
+        Frame st[64]; // 先压右再压左，栈深不超过树高 + 1
+        int top = 0;
+        st[top++] = {0, n, 0, &root};
+        while (top > 0) {
+            Frame f = st[--top];
+            if (f.lo >= f.hi) {
+                *f.slot = NIL;
+                continue;
+            }
+            int mid = f.lo + (f.hi - f.lo) / 2;
+            int id = pool.alloc();
+            Node& nd = pool[id];
+            nd.val = a[mid];
+            nd.size = f.hi - f.lo;
+#if BST_BALANCE == BST_TREAP
+            nd.aux = bulkPriority(f.depth, n);
+#else
+            nd.aux = bitLength(f.hi - f.lo); // AVL：左右大小最多差 1，高度也最多差 1
+#endif
+            *f.slot = id;
+            st[top++] = {mid + 1, f.hi, f.depth + 1, &nd.right};
+            st[top++] = {f.lo, mid, f.depth + 1, &nd.left};
+        }
+        return true;
+    }
+
+    // 小于 x 的键的个数
+    int countLess(int x) {
+        int c = 0, p = root;
+        while (p != NIL) {
+            if (pool[p].val < x) {
+                c += pool[pool[p].left].size + 1;
+                p = pool[p].right;
+            } else {
+                p = pool[p].left;
+            }
+        }
+        return c;
+    }
+
+    // 小于等于 x 的键的个数
+    int countLessEq(int x) {
+        int c = 0, p = root;
+        while (p != NIL) {
+            if (pool[p].val <= x) {
+                c += pool[pool[p].left].size + 1;
+                p = pool[p].right;
+            } else {
+                p = pool[p].left;
+            }
+        }
+        return c;
+    }
+
+    // 区间计数：[a, b] 中的键数，两次 O(log n) 下降，不逐个枚举
+    int countRange(int a, int b) {
+        if (a > b) return 0;
+        return countLessEq(b) - countLess(a);
+    }
+
+    // 第 k 小的值（k 从 1 开始）
+    bool select(int k, int* out) {
+        if (k < 1 || k > size()) return false;
+        int p = root;
+        while (true) {
+            int leftSize = pool[pool[p].left].size;
+            if (k == leftSize + 1) break;
+            if (k <= leftSize) {
+                p = pool[p].left;
+            } else {
+                k -= leftSize + 1;
+                p = pool[p].right;
+            }
+        }
+        *out = pool[p].val;
+        return true;
+    }
+
+    // 区间 [a, b] 内第 k 小的值：整体名次 = (小于 a 的个数) + k
+    bool kthInRange(int a, int b, int k, int* out) {
+        if (k < 1 || k > countRange(a, b)) return false;
+        return select(countLess(a) + k, out);
+    }
+
+    // 删除 [a, b] 内的全部键，返回删除的个数。
+    // 拆成 (< a) / [a, b] / (> b) 三段，中间一段整体回收，两端再拼回去
+    int eraseRange(int a, int b) {
+        if (a > b) return 0;
+        int l, mid, r;
+        split(root, a, false, l, mid);
+        split(mid, b, true, mid, r);
+        int removed = pool[mid].size;
+        releaseTree(mid);
+        root = join2(l, r);
+        return removed;
+    }
+
+    // split/join 的对外接口：拆下来的部分以子树句柄的形式返回，
+    // 节点仍在本树的内存池里，只能交还给同一棵树的 join
+    struct Detached {
+        int root;
+    };
+
+    // 把所有 > key 的键拆下来，树里只保留 <= key 的部分
+    Detached splitOff(int key) {
+        int l, r;
+        split(root, key, true, l, r);
+        root = l;
+        Detached d = {r};
+        return d;
+    }
+
+    int detachedSize(Detached d) {
+        return pool[d.root].size;
+    }
+
+    // 把拆下的部分拼回来：要求它整体位于当前树的一侧，否则返回 false 且不做任何修改
+    bool join(Detached d) {
+        if (d.root == NIL) return true;
+        if (root == NIL) root = d.root;
+        else if (maxVal(root) < minVal(d.root)) root = join2(root, d.root);
+        else if (maxVal(d.root) < minVal(root)) root = join2(d.root, root);
+        else return false;
+        return true;
+    }
+};
+
+// -------------------- 有界整数域引擎 (Fenwick Tree) --------------------
+// 当输入的值来自一个事先已知的有界区间 [lo, hi]（例如价格档位）时，指针树就显得多余了：
+// 直接把值当作下标，用树状数组维护“每个值出现了几次”的前缀和：
+//   * 插入/删除：单点 ±1，O(log U)
+//   * 查找：成员位图 present[] 一次访存，O(1)
+//   * 按名次查找：在树状数组上做二进制倍增 (binary lifting)，O(log U)，
+//     每一步只访问 tree[pos + 2^j] 一个数组元素，没有任何指针追逐
+// 这里 U = hi - lo + 1。没有“比较路径”的概念，成功时 xorPath 字段返回本次操作涉及的值
+// （与 BTree_Rank_Ops.cpp 的约定相同）。超出声明区间的值一律视为失败。
+class FenwickRank {
+private:
+    int lo, hi;
+    int U;
+    int topStep;              // 不超过 U 的最大 2 的幂，倍增的起点
+    int* tree;                // tree[1..U]，下标 i 对应值 lo + i - 1
+    unsigned long long* present; // 成员位图
+    int total;
+
+    bool inRange(int v) const {
+        return v >= lo && v <= hi;
+    }
+
+    void add(int i, int delta) {
+        for (; i <= U; i += i & -i) tree[i] += delta;
+    }
+
+    // 值 <= lo + i - 1 的个数
+    int prefix(int i) const {
+        int s = 0;
+        for (; i > 0; i -= i & -i) s += tree[i];
+        return s;
+    }
+
+    bool has(int i) const {
+        return (present[(i - 1) >> 6] >> ((i - 1) & 63)) & 1;
+    }
+
+    void flip(int i) {
+        present[(i - 1) >> 6] ^= 1ULL << ((i - 1) & 63);
+    }
+
+    // 第 k 小对应的下标：从最高位开始，能跳就跳（跳过的那一段总数 < k）
+    int selectIndex(int k) const {
+        int pos = 0;
+        for (int step = topStep; step > 0; step >>= 1) {
+            if (pos + step <= U && tree[pos + step] < k) {
+                pos += step;
+                k -= tree[pos];
+            }
+        }
+        return pos + 1;
+    }
+
+    void eraseIndex(int i) {
+        flip(i);
+        add(i, -1);
+        total--;
+    }
+
+public:
+    FenwickRank(int low, int high) : lo(low), hi(high), total(0) {
+        U = hi - lo + 1;
+        topStep = 1;
+        while (topStep * 2 <= U) topStep *= 2;
+        tree = new int[U + 1];
+        present = new unsigned long long[(U + 63) / 64];
+        memset(tree, 0, sizeof(int) * (U + 1));
+        memset(present, 0, sizeof(unsigned long long) * ((U + 63) / 64));
+    }
+
+    ~FenwickRank() {
+        delete[] tree;
+        delete[] present;
+    }
+
+    FenwickRank(const FenwickRank&) = delete;
+    FenwickRank& operator=(const FenwickRank&) = delete;
 
+    int size() { return total; }
+
+    OpResult insert(int val) {
+        OpResult res = {false, val};
+        if (!inRange(val)) return res;
+        int i = val - lo + 1;
+        if (has(i)) return res;
+        flip(i);
+        add(i, 1);
+        total++;
+        res.ok = true;
+        return res;
+    }
+
+    OpResult search(int val) {
+        OpResult res = {inRange(val) && has(val - lo + 1), val};
+        return res;
+    }
+
+    OpResult remove(int val) {
+        OpResult res = {false, val};
+        if (!inRange(val) || !has(val - lo + 1)) return res;
+        eraseIndex(val - lo + 1);
+        res.ok = true;
+        return res;
+    }
+
+    OpResult searchByRank(int k) {
+        OpResult res = {false, 0};
+        if (k < 1 || k > total) return res;
+        res.ok = true;
+        res.xorPath = lo + selectIndex(k) - 1;
+        return res;
+    }
+
+    OpResult removeByRank(int k) {
+        OpResult res = {false, 0};
+        if (k < 1 || k > total) return res;
+        int i = selectIndex(k);
+        eraseIndex(i);
+        res.ok = true;
+        res.xorPath = lo + i - 1;
+        return res;
+    }
+
+    // 批量装载：先填计数再 O(U) 自底向上建树状数组（每个节点把自己累加到父节点）
+    bool buildFromSorted(const int* a, int n) {
+        for (int i = 0; i < n; ++i) {
+            if (!inRange(a[i]) || (i > 0 && a[i - 1] >= a[i])) return false;
+        }
+        memset(tree, 0, sizeof(int) * (U + 1));
+        memset(present, 0, sizeof(unsigned long long) * ((U + 63) / 64));
+        for (int i = 0; i < n; ++i) {
+            int idx = a[i] - lo + 1;
+            tree[idx] = 1;
+            flip(idx);
+        }
+        for (int i = 1; i <= U; ++i) {
+            int parent = i + (i & -i);
+            if (parent <= U) tree[parent] += tree[i];
+        }
+        total = n;
+        return true;
+    }
+
+    int countLess(int x) {
+        if (x <= lo) return 0;
+        if (x > hi) return total;
+        return prefix(x - lo);
+    }
+
+    int countLessEq(int x) {
+        if (x < lo) return 0;
+        if (x >= hi) return total;
+        return prefix(x - lo + 1);
+    }
+
+    int countRange(int a, int b) {
+        if (a > b) return 0;
+        return countLessEq(b) - countLess(a);
+    }
+
+    bool select(int k, int* out) {
+        if (k < 1 || k > total) return false;
+        *out = lo + selectIndex(k) - 1;
+        return true;
+    }
+
+    bool kthInRange(int a, int b, int k, int* out) {
+        if (k < 1 || k > countRange(a, b)) return false;
+        return select(countLess(a) + k, out);
+    }
+
+    // 区间删除：按 64 位一组扫描成员位图，只对真正存在的值做 O(log U) 的删除
+    int eraseRange(int a, int b) {
+        if (a < lo) a = lo;
+        if (b > hi) b = hi;
+        if (a > b) return 0;
+        int removed = 0;
+        int first = a - lo, last = b - lo; // 0 起的位下标
+        for (int w = first >> 6; w <= (last >> 6); ++w) {
+            unsigned long long bits = present[w];
+            if (w == (first >> 6)) bits &= ~0ULL << (first & 63);
+            if (w == (last >> 6) && (last & 63) != 63) bits &= (1ULL << ((last & 63) + 1)) - 1;
+            while (bits) {
+                int bit = __builtin_ctzll(bits);
+                bits &= bits - 1;
+                eraseIndex(w * 64 + bit + 1);
+                removed++;
+            }
+        }
+        return removed;
+    }
+};
+
+// 超过这个规模的值域就不再用 Fenwick（int 计数 + 位图约 4.1 字节/值）
+const long long FENWICK_MAX_UNIVERSE = 1LL << 26;
 
 // -------------------- 主函数 --------------------
 
-int main() {
-    // 初始化根节点为空
-    Node* root = nullptr;
-    
-    int m;
-    // 读入操作总数 m
-    if (scanf("%d", &m) != 1) return 0;
+// 两种引擎接口相同，主循环写成模板，编译期分别实例化
+template <class Tree>
+void runOps(Tree& tree, int m) {
+    int* snapshot = nullptr; // 操作 7 的输入缓冲
+    int snapshotCap = 0;
 
     while (m--) {
         int op, val;
         // 读入 操作类型 和 操作数
-        scanf("%d %d", &op, &val);
-
-        // 每次操作前，重置全局状态
-        xor_path = 0;
-        success_flag = false;
-
-        if (op == 0) { // --- 插入 ---
-            insert(root, val);
-            // 逻辑说明：
-            // 1. 如果 success_flag 为 false，说明插入了重复值 -> 题目要求输出 0
-            // 2. 如果 success_flag 为 true，输出 xor_path
-            // 注意：如果是空树插入第一个节点，xor_path 为 0，也是正确的
-            if (!success_flag) printf("0\n");
-            else printf("%d\n", xor_path);
-        }
-        else if (op == 1) { // --- 查找 ---
-            search(root, val);
-            // 如果没找到 (flag=false)，输出 0
-            if (!success_flag) printf("0\n");
-            else printf("%d\n", xor_path);
-        }
-        else if (op == 2) { // --- 删除 ---
-            remove(root, val);
-            if (!success_flag) printf("0\n");
-            else printf("%d\n", xor_path);
-        }
-        else if (op == 3) { // --- 按名次查找 ---
-            // 边界检查：如果 k 超过了树的总节点数，显然不存在
-            if (root && val > root->size) {
-                printf("0\n");
-            } else {
-                searchByRank(root, val);
-                if (!success_flag) printf("0\n");
-                else printf("%d\n", xor_path);
-            }
+        if (scanf("%d %d", &op, &val) != 2) break;
+
+        OpResult res = {false, 0};
+        if (op == 0) res = tree.insert(val);            // --- 插入 ---
+        else if (op == 1) res = tree.search(val);       // --- 查找 ---
+        else if (op == 2) res = tree.remove(val);       // --- 删除 ---
+        else if (op == 3) res = tree.searchByRank(val); // --- 按名次查找 ---
+        else if (op == 4) res = tree.removeByRank(val); // --- 按名次删除 ---
+        else if (op == 5) { // --- 区间计数：5 a b，输出 [a, b] 内的键数 ---
+            int b = 0;
+            if (scanf("%d", &b) != 1) break;
+            printf("%d\n", tree.countRange(val, b));
+            continue;
         }
-        else if (op == 4) { // --- 按名次删除 ---
-            // 边界检查
-            if (root && val > root->size) {
-                printf("0\n");
-            } else {
-                removeByRank(root, val);
-                if (!success_flag) printf("0\n");
-                else printf("%d\n", xor_path);
+        else if (op == 6) { // --- 区间第 k 小：6 a b k，不存在输出 0 ---
+            int b = 0, k = 0, out = 0;
+            if (scanf("%d %d", &b, &k) != 2) break;
+            if (!tree.kthInRange(val, b, k, &out)) out = 0;
+            printf("%d\n", out);
+            continue;
+        }
+        else if (op == 7) { // --- 批量装载：7 n a1 ... an（严格递增），输出装载后的大小，失败输出 0 ---
+            if (val > snapshotCap) {
+                delete[] snapshot;
+                snapshotCap = val;
+                snapshot = new int[snapshotCap];
             }
+            int n = 0;
+            while (n < val && scanf("%d", &snapshot[n]) == 1) ++n;
+            if (n == val && tree.buildFromSorted(snapshot, n)) printf("%d\n", tree.size());
+            else printf("0\n");
+            continue;
+        }
+        else if (op == 8) { // --- 区间删除：8 a b，输出删除的个数 ---
+            int b = 0;
+            if (scanf("%d", &b) != 1) break;
+            printf("%d\n", tree.eraseRange(val, b));
+            continue;
         }
+
+        // 操作失败（插入重复值、查不到、名次越界）题目要求输出 0，否则输出 xorPath
+        // 注意：如果是空树插入第一个节点，xorPath 为 0，也是正确的
+        if (!res.ok) printf("0\n");
+        else printf("%d\n", res.xorPath);
     }
 
+    delete[] snapshot;
+}
+
+// 命令行参数（可省略）：
+//   --range L R  事先声明所有值都落在 [L, R] 内。值域不太大时自动改用 FenwickRank 引擎，
+//                此时成功的操作输出涉及的值而不是 xor_path（见 FenwickRank 的说明）
+//                L、R 必须在 int 范围内，否则忽略这个声明，仍用平衡树
+int main(int argc, char* argv[]) {
+    bool declared = false;
+    long long lo = 0, hi = -1;
+    for (int i = 1; i + 2 < argc; ++i) {
+        if (strcmp(argv[i], "--range") == 0) {
+            lo = atoll(argv[i + 1]);
+            hi = atoll(argv[i + 2]);
+            declared = (lo >= INT_MIN && hi <= INT_MAX);
+            if (!declared) fprintf(stderr, "--range: bounds must fit in int, ignored\n");
+        }
+    }
+
+    int m;
+    // 读入操作总数 m
+    if (scanf("%d", &m) != 1) return 0;
+
+    if (declared && lo <= hi && hi - lo + 1 <= FENWICK_MAX_UNIVERSE) {
+        FenwickRank tree((int)lo, (int)hi);
+        runOps(tree, m);
+    } else {
+        RankTree tree;
+        runOps(tree, m);
+    }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,478 @@
+#include <iostream>
+#include <cstdio>  // scanf/printf
+#include <cstring> // memmove
+#include <climits>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// ============================================================
+// B+ 树顺序统计索引 (Order-Statistic B+ Tree)
+// ============================================================
+// BST_Rank_Ops.cpp 即使做了平衡，二叉节点 {val, size, left, right} 每下降一层
+// 也要付出一次缓存未命中，10^7 个键时树高 ~24 层。
+// 这里把每个节点做宽：叶子存 64 个有序键，内部节点最多 32 个孩子，
+// 并为每个孩子记录子树键数 cnt[i]（相当于把 size 域摊到父节点里）：
+//   * 10^7 个键时树高只有 4~5 层，每层的数据都是连续数组
+//   * 节点内定位用 SIMD 一次比较 8 个（AVX2）/ 4 个（SSE2）键，没有分支预测失败
+//   * 按名次下降时顺序扫描 cnt[]，同样是连续内存
+//
+// 支持与 BST_Rank_Ops.cpp 相同的 5 种操作（输入格式相同）：
+//   0 x 插入    1 x 查找    2 x 删除    3 k 查第 k 小    4 k 删第 k 小
+// 输出约定：B+ 树没有“沿路径逐个比较”的过程，xor_path 无从定义，
+// 所以失败时输出 0，成功时输出本次操作涉及的元素值
+// （插入/查找/删除为 x 本身，按名次操作为第 k 小的值）。
+
+const int LEAF_CAP = 64;              // 叶子最多存放的键数
+const int LEAF_MIN = LEAF_CAP / 4;    // 叶子低于这个数就与兄弟合并或借键
+const int INNER_CAP = 32;             // 内部节点最多的孩子数
+const int INNER_MIN = INNER_CAP / 4;
+const int MAX_DEPTH = 16;             // 32^16 远超 int 范围，路径数组不会越界
+
+// -------------------- 节点内 SIMD 查找 --------------------
+// 未使用的槽位统一填 INT_MAX，这样可以对整个定长数组做比较，
+// 循环次数是编译期常量，编译器会完全展开。
+
+// 统计 a[0..N) 中严格小于 key 的个数
+template <int N>
+inline int countLess(const int* a, int key) {
+#if defined(__AVX2__)
+    __m256i k = _mm256_set1_epi32(key);
+    int c = 0;
+    for (int i = 0; i < N; i += 8) {
+        __m256i v = _mm256_load_si256((const __m256i*)(a + i));
+        __m256i lt = _mm256_cmpgt_epi32(k, v); // v < key
+        c += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(lt)));
+    }
+    return c;
+#elif defined(__SSE2__)
+    __m128i k = _mm_set1_epi32(key);
+    int c = 0;
+    for (int i = 0; i < N; i += 4) {
+        __m128i v = _mm_load_si128((const __m128i*)(a + i));
+        __m128i lt = _mm_cmpgt_epi32(k, v);
+        c += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(lt)));
+    }
+    return c;
+#else
+    int c = 0;
+    for (int i = 0; i < N; ++i) c += (a[i] < key);
+    return c;
+#endif
+}
+
+// 统计 a[0..N) 中小于等于 key 的个数 = N - (大于 key 的个数)
+template <int N>
+inline int countLessEq(const int* a, int key) {
+#if defined(__AVX2__)
+    __m256i k = _mm256_set1_epi32(key);
+    int c = 0;
+    for (int i = 0; i < N; i += 8) {
+        __m256i v = _mm256_load_si256((const __m256i*)(a + i));
+        __m256i gt = _mm256_cmpgt_epi32(v, k);
+        c += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(gt)));
+    }
+    return N - c;
+#elif defined(__SSE2__)
+    __m128i k = _mm_set1_epi32(key);
+    int c = 0;
+    for (int i = 0; i < N; i += 4) {
+        __m128i v = _mm_load_si128((const __m128i*)(a + i));
+        __m128i gt = _mm_cmpgt_epi32(v, k);
+        c += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(gt)));
+    }
+    return N - c;
+#else
+    int c = 0;
+    for (int i = 0; i < N; ++i) c += (a[i] <= key);
+    return c;
+#endif
+}
+
+// -------------------- 节点定义 --------------------
+
+struct BNode {
+    int n;      // 叶子：键数；内部节点：孩子数
+    bool leaf;
+};
+
+struct alignas(64) Leaf : BNode {
+    alignas(64) int keys[LEAF_CAP]; // 有序键，[n, LEAF_CAP) 填 INT_MAX
+};
+
+// sep[i] 分隔 child[i] 与 child[i+1]：child[i] 的键都 < sep[i] <= child[i+1] 的键
+// cnt[i] 是 child[i] 子树中的键总数，按名次下降时用它代替 size 域
+struct alignas(64) Inner : BNode {
+    alignas(64) int sep[INNER_CAP]; // 有效的是 [0, n-1)，其余填 INT_MAX
+    int cnt[INNER_CAP];
+    BNode* child[INNER_CAP];
+};
+
+// -------------------- B+ 树 --------------------
+
+class BPlusRankTree {
+private:
+    BNode* root;
+    int height; // 内部节点层数，0 表示根就是叶子
+    int total;  // 键总数
+
+    // 一次下降记录的路径：path[d] 是第 d 层内部节点，idx[d] 是走向的孩子下标
+    Inner* path[MAX_DEPTH];
+    int idx[MAX_DEPTH];
+
+    static Leaf* newLeaf() {
+        Leaf* p = new Leaf;
+        p->n = 0;
+        p->leaf = true;
+        for (int i = 0; i < LEAF_CAP; ++i) p->keys[i] = INT_MAX;
+        return p;
+    }
+
+    static Inner* newInner() {
+        Inner* p = new Inner;
+        p->n = 0;
+        p->leaf = false;
+        for (int i = 0; i < INNER_CAP; ++i) {
+            p->sep[i] = INT_MAX;
+            p->cnt[i] = 0;
+            p->child[i] = nullptr;
+        }
+        return p;
+    }
+
+    static int sumCnt(const Inner* p) {
+        int s = 0;
+        for (int i = 0; i < p->n; ++i) s += p->cnt[i];
+        return s;
+    }
+
+    static int countOf(BNode* p) {
+        return p->leaf ? p->n : sumCnt((Inner*)p);
+    }
+
+    static void freeAll(BNode* p) {
+        if (!p->leaf) {
+            Inner* in = (Inner*)p;
+            for (int i = 0; i < in->n; ++i) freeAll(in->child[i]);
+            delete in;
+        } else {
+            delete (Leaf*)p;
+        }
+    }
+
+    // 按键下降到叶子，沿途记录路径
+    Leaf* descendByKey(int key) {
+        BNode* p = root;
+        for (int d = 0; d < height; ++d) {
+            Inner* in = (Inner*)p;
+            int c = countLessEq<INNER_CAP>(in->sep, key);
+            if (c > in->n - 1) c = in->n - 1; // 填充的 INT_MAX 也可能被算进来，夹紧到最后一个孩子
+            path[d] = in;
+            idx[d] = c;
+            p = in->child[c];
+        }
+        return (Leaf*)p;
+    }
+
+    // 按名次下降到叶子，k 从 1 开始，返回后 k 是叶子内的名次
+    Leaf* descendByRank(int& k) {
+        BNode* p = root;
+        for (int d = 0; d < height; ++d) {
+            Inner* in = (Inner*)p;
+            int c = 0;
+            while (k > in->cnt[c]) k -= in->cnt[c++];
+            path[d] = in;
+            idx[d] = c;
+            p = in->child[c];
+        }
+        return (Leaf*)p;
+    }
+
+    // 在内部节点 p 的第 pos 个孩子之后插入新孩子 right，分隔键为 s
+    static void innerInsertAfter(Inner* p, int pos, int s, BNode* right, int rightCnt) {
+        int moveN = p->n - 1 - pos;
+        memmove(p->sep + pos + 1, p->sep + pos, sizeof(int) * (p->n - 1 - pos));
+        memmove(p->cnt + pos + 2, p->cnt + pos + 1, sizeof(int) * moveN);
+        memmove(p->child + pos + 2, p->child + pos + 1, sizeof(BNode*) * moveN);
+        p->sep[pos] = s;
+        p->cnt[pos + 1] = rightCnt;
+        p->child[pos + 1] = right;
+        p->n++;
+    }
+
+    // 删除内部节点 p 的第 pos 个孩子（以及它左边的分隔键 sep[pos-1]），pos >= 1
+    static void innerEraseChild(Inner* p, int pos) {
+        memmove(p->sep + pos - 1, p->sep + pos, sizeof(int) * (p->n - 1 - pos));
+        memmove(p->cnt + pos, p->cnt + pos + 1, sizeof(int) * (p->n - 1 - pos));
+        memmove(p->child + pos, p->child + pos + 1, sizeof(BNode*) * (p->n - 1 - pos));
+        p->n--;
+        p->sep[p->n - 1] = INT_MAX;
+        p->cnt[p->n] = 0;
+        p->child[p->n] = nullptr;
+    }
+
+    // 把满的叶子对半分裂，返回右半部分，*sepOut 为右半部分的最小键
+    static Leaf* splitLeaf(Leaf* l, int* sepOut) {
+        Leaf* r = newLeaf();
+        int half = l->n / 2;
+        r->n = l->n - half;
+        memcpy(r->keys, l->keys + half, sizeof(int) * r->n);
+        for (int i = half; i < l->n; ++i) l->keys[i] = INT_MAX;
+        l->n = half;
+        *sepOut = r->keys[0];
+        return r;
+    }
+
+    // 把满的内部节点对半分裂，中间的分隔键上提到父节点
+    static Inner* splitInner(Inner* l, int* sepOut) {
+        Inner* r = newInner();
+        int half = l->n / 2; // 左边保留 half 个孩子
+        r->n = l->n - half;
+        *sepOut = l->sep[half - 1];
+        memcpy(r->sep, l->sep + half, sizeof(int) * (r->n - 1));
+        memcpy(r->cnt, l->cnt + half, sizeof(int) * r->n);
+        memcpy(r->child, l->child + half, sizeof(BNode*) * r->n);
+        for (int i = half - 1; i < INNER_CAP; ++i) l->sep[i] = INT_MAX;
+        for (int i = half; i < l->n; ++i) {
+            l->cnt[i] = 0;
+            l->child[i] = nullptr;
+        }
+        l->n = half;
+        return r;
+    }
+
+    // 删除叶子 leaf 中下标 pos 的键，然后自底向上修复下溢
+    // 调用前 path/idx 必须是到达 leaf 的路径
+    void eraseAt(Leaf* leaf, int pos) {
+        memmove(leaf->keys + pos, leaf->keys + pos + 1, sizeof(int) * (leaf->n - 1 - pos));
+        leaf->keys[--leaf->n] = INT_MAX;
+        for (int d = 0; d < height; ++d) path[d]->cnt[idx[d]]--;
+        total--;
+
+        // 从叶子往上逐层检查下溢
+        BNode* cur = leaf;
+        for (int d = height - 1; d >= 0; --d) {
+            int minN = cur->leaf ? LEAF_MIN : INNER_MIN;
+            if (cur->n >= minN) break;
+            Inner* parent = path[d];
+            int ci = idx[d];
+            // 优先和左兄弟配对，最左的孩子和右兄弟配对；统一成 (parent, 左下标 li)
+            int li = (ci > 0) ? ci - 1 : ci;
+            if (parent->n < 2) break; // 只有一个孩子时无法配对（只会出现在根被收缩之前）
+            if (cur->leaf) fixLeafPair(parent, li);
+            else fixInnerPair(parent, li);
+            cur = parent;
+        }
+
+        // 根节点只剩一个孩子时降低树高
+        while (height > 0 && root->n == 1) {
+            Inner* old = (Inner*)root;
+            root = old->child[0];
+            delete old;
+            height--;
+        }
+    }
+
+    // 相邻叶子 parent->child[li] 与 child[li+1]：能放下就合并，否则平均分配
+    static void fixLeafPair(Inner* parent, int li) {
+        Leaf* a = (Leaf*)parent->child[li];
+        Leaf* b = (Leaf*)parent->child[li + 1];
+        int sum = a->n + b->n;
+        if (sum <= LEAF_CAP) {
+            memcpy(a->keys + a->n, b->keys, sizeof(int) * b->n);
+            a->n = sum;
+            parent->cnt[li] = sum;
+            innerEraseChild(parent, li + 1);
+            delete b;
+            return;
+        }
+        // 重新分配：先拼到临时数组里再对半切
+        int tmp[LEAF_CAP * 2];
+        memcpy(tmp, a->keys, sizeof(int) * a->n);
+        memcpy(tmp + a->n, b->keys, sizeof(int) * b->n);
+        int half = sum / 2;
+        for (int i = 0; i < LEAF_CAP; ++i) {
+            a->keys[i] = (i < half) ? tmp[i] : INT_MAX;
+            b->keys[i] = (i < sum - half) ? tmp[half + i] : INT_MAX;
+        }
+        a->n = half;
+        b->n = sum - half;
+        parent->sep[li] = b->keys[0];
+        parent->cnt[li] = a->n;
+        parent->cnt[li + 1] = b->n;
+    }
+
+    // 相邻内部节点的合并/重新分配，父节点的分隔键要“下沉”到两者之间
+    static void fixInnerPair(Inner* parent, int li) {
+        Inner* a = (Inner*)parent->child[li];
+        Inner* b = (Inner*)parent->child[li + 1];
+        int sum = a->n + b->n;
+        // 拼成一个临时的孩子序列：a 的孩子 + 下沉的分隔键 + b 的孩子
+        int tsep[INNER_CAP * 2];
+        int tcnt[INNER_CAP * 2];
+        BNode* tch[INNER_CAP * 2];
+        memcpy(tsep, a->sep, sizeof(int) * (a->n - 1));
+        tsep[a->n - 1] = parent->sep[li];
+        memcpy(tsep + a->n, b->sep, sizeof(int) * (b->n - 1));
+        memcpy(tcnt, a->cnt, sizeof(int) * a->n);
+        memcpy(tcnt + a->n, b->cnt, sizeof(int) * b->n);
+        memcpy(tch, a->child, sizeof(BNode*) * a->n);
+        memcpy(tch + a->n, b->child, sizeof(BNode*) * b->n);
+
+        if (sum <= INNER_CAP) {
+            for (int i = 0; i < INNER_CAP; ++i) {
+                a->sep[i] = (i < sum - 1) ? tsep[i] : INT_MAX;
+                a->cnt[i] = (i < sum) ? tcnt[i] : 0;
+                a->child[i] = (i < sum) ? tch[i] : nullptr;
+            }
+            a->n = sum;
+            parent->cnt[li] = sumCnt(a);
+            innerEraseChild(parent, li + 1);
+            delete b;
+            return;
+        }
+        int half = sum / 2;
+        for (int i = 0; i < INNER_CAP; ++i) {
+            a->sep[i] = (i < half - 1) ? tsep[i] : INT_MAX;
+            a->cnt[i] = (i < half) ? tcnt[i] : 0;
+            a->child[i] = (i < half) ? tch[i] : nullptr;
+            int j = half + i;
+            b->sep[i] = (i < sum - half - 1) ? tsep[j] : INT_MAX;
+            b->cnt[i] = (i < sum - half) ? tcnt[j] : 0;
+            b->child[i] = (i < sum - half) ? tch[j] : nullptr;
+        }
+        a->n = half;
+        b->n = sum - half;
+        parent->sep[li] = tsep[half - 1];
+        parent->cnt[li] = sumCnt(a);
+        parent->cnt[li + 1] = sumCnt(b);
+    }
+
+public:
+    BPlusRankTree() : root(newLeaf()), height(0), total(0) {}
+
+    ~BPlusRankTree() {
+        freeAll(root);
+    }
+
+    int size() const { return total; }
+
+    // 【操作 0】插入，已存在返回 false
+    bool insert(int key) {
+        Leaf* leaf = descendByKey(key);
+        int pos = countLess<LEAF_CAP>(leaf->keys, key);
+        if (pos < leaf->n && leaf->keys[pos] == key) return false;
+
+        for (int d = 0; d < height; ++d) path[d]->cnt[idx[d]]++;
+        total++;
+
+        // 叶子满了先分裂，再决定插到哪一半
+        BNode* right = nullptr;
+        int rightSep = 0;
+        if (leaf->n == LEAF_CAP) {
+            Leaf* r = splitLeaf(leaf, &rightSep);
+            if (pos > leaf->n) {
+                pos -= leaf->n;
+                leaf = r;
+            }
+            right = r;
+        }
+        memmove(leaf->keys + pos + 1, leaf->keys + pos, sizeof(int) * (leaf->n - pos));
+        leaf->keys[pos] = key;
+        leaf->n++;
+
+        // 分裂向上传播：每层在父节点中插入 (分隔键, 右半部分)，父节点满了继续分裂
+        for (int d = height - 1; d >= 0 && right != nullptr; --d) {
+            Inner* parent = path[d];
+            int ci = idx[d];
+            BNode* left = parent->child[ci];
+            BNode* carry = right;
+            int carrySep = rightSep;
+            right = nullptr;
+            if (parent->n == INNER_CAP) {
+                Inner* pr = splitInner(parent, &rightSep);
+                right = pr;
+                if (ci >= parent->n) { // 被分裂的孩子落在右半部分
+                    ci -= parent->n;
+                    parent = pr;
+                }
+            }
+            parent->cnt[ci] = countOf(left);
+            innerInsertAfter(parent, ci, carrySep, carry, countOf(carry));
+        }
+        if (right != nullptr) { // 根分裂，树长高一层
+            Inner* nr = newInner();
+            nr->n = 2;
+            nr->sep[0] = rightSep;
+            nr->child[0] = root;
+            nr->child[1] = right;
+            nr->cnt[0] = countOf(root);
+            nr->cnt[1] = countOf(right);
+            root = nr;
+            height++;
+        }
+        return true;
+    }
+
+    // 【操作 1】查找
+    bool contains(int key) {
+        Leaf* leaf = descendByKey(key);
+        int pos = countLess<LEAF_CAP>(leaf->keys, key);
+        return pos < leaf->n && leaf->keys[pos] == key;
+    }
+
+    // 【操作 2】删除，不存在返回 false
+    bool erase(int key) {
+        Leaf* leaf = descendByKey(key);
+        int pos = countLess<LEAF_CAP>(leaf->keys, key);
+        if (pos >= leaf->n || leaf->keys[pos] != key) return false;
+        eraseAt(leaf, pos);
+        return true;
+    }
+
+    // 【操作 3】第 k 小（k 从 1 开始），越界返回 false
+    bool select(int k, int* out) {
+        if (k < 1 || k > total) return false;
+        Leaf* leaf = descendByRank(k);
+        *out = leaf->keys[k - 1];
+        return true;
+    }
+
+    // 【操作 4】删除第 k 小，*out 返回被删除的值
+    bool eraseByRank(int k, int* out) {
+        if (k < 1 || k > total) return false;
+        Leaf* leaf = descendByRank(k);
+        *out = leaf->keys[k - 1];
+        eraseAt(leaf, k - 1);
+        return true;
+    }
+};
+
+// -------------------- 主函数 --------------------
+
+int main() {
+    BPlusRankTree tree;
+
+    int m;
+    if (scanf("%d", &m) != 1) return 0;
+
+    while (m--) {
+        int op, val;
+        if (scanf("%d %d", &op, &val) != 2) break;
+
+        bool ok = false;
+        int res = val;
+        if (op == 0) ok = tree.insert(val);
+        else if (op == 1) ok = tree.contains(val);
+        else if (op == 2) ok = tree.erase(val);
+        else if (op == 3) ok = tree.select(val, &res);
+        else if (op == 4) ok = tree.eraseByRank(val, &res);
+
+        if (!ok) printf("0\n");
+        else printf("%d\n", res);
+    }
+
+    return 0;
+}
@@ -1,10 +1,13 @@
 #include <iostream>
 #include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 using namespace std;
 
-const int MAXN = 100005;
-
 // 定义二叉树节点 (静态链表形式)
 // left 和 right 存储的是子节点在数组中的下标，-1 表示空
 struct Node {
@@ -12,72 +15,183 @@ struct Node {
     int right;
     int size;   // 子树节点数
     int height; // 子树高度
-} tree[MAXN];
+};
+
+// 节点数组按读入的 n 在堆上分配（下标 1~n），不再预留固定的 MAXN
+Node* tree = nullptr;
 
 // ==========================================
 // 手写简易栈 (用于非递归遍历)
 // ==========================================
+// 容量在构造时按需给定，数据放在堆上：
+// 以前每个栈对象内嵌一个 MAXN 大小的数组（约 400 KB），局部变量一多就会压垮调用栈
 struct MyStack {
-    int data[MAXN];
+    int* data;
     int topIndex;
 
-    MyStack() { topIndex = 0; }
+    explicit MyStack(int capacity) { data = new int[capacity > 0 ? capacity : 1]; topIndex = 0; }
+    ~MyStack() { delete[] data; }
+    MyStack(const MyStack&) = delete;
+    MyStack& operator=(const MyStack&) = delete;
     void push(int val) { data[topIndex++] = val; }
     int pop() { return data[--topIndex]; }
     bool empty() { return topIndex == 0; }
     int top() { return data[topIndex - 1]; }
     void clear() { topIndex = 0; }
     // 这个栈服从先进后出原则
-    // 所以在之后的后序遍历中会用到两个栈来实现逆序
+    // 后序遍历和统计子树信息都只用一个栈，配合“上一个访问的节点”判断右子树是否处理完
 };
 
 // ==========================================
-// 手写简易队列 (用于层次遍历)
+// 线程屏障 (用于按层并行聚合)
 // ==========================================
-struct MyQueue {
-    int data[MAXN];
-    int head;
-    int tail;
-
-    MyQueue() { head = 0; tail = 0; }
-    void push(int val) { data[tail++] = val; }
-    int pop() { return data[head++]; }
-    bool empty() { return head == tail; }
+// 所有线程都调用 wait() 之后才一起放行；gen 区分前后两轮，防止快线程跑进下一轮
+class Barrier {
+private:
+    mutex m;
+    condition_variable cv;
+    int count;
+    int waiting;
+    unsigned int gen;
+
+public:
+    explicit Barrier(int threads) : count(threads), waiting(0), gen(0) {}
+
+    void wait() {
+        unique_lock<mutex> lock(m);
+        unsigned int myGen = gen;
+        if (++waiting == count) {
+            waiting = 0;
+            gen++;
+            cv.notify_all();
+        } else {
+            cv.wait(lock, [&] { return gen != myGen; });
+        }
+    }
 };
 
+// ==========================================
+// 子树聚合函数 (用于 aggregateBottomUp)
+// ==========================================
+// 调用 combine(u, l, r) 时，孩子 l、r（-1 表示空）的结果一定已经算好，
+// 函数只需根据孩子的结果写出 u 自己的结果。不同的 u 可能在不同线程上同时计算，
+// 所以只允许写 u 自己的那一份数据。
+
+// 子树大小 + 高度 (printMetrics 使用)
+struct SizeHeightAgg {
+    void operator()(int u, int l, int r) const {
+        int l_size = (l == -1) ? 0 : tree[l].size;
+        int r_size = (r == -1) ? 0 : tree[r].size;
+
+        int l_height = (l == -1) ? 0 : tree[l].height;
+        int r_height = (r == -1) ? 0 : tree[r].height;
+
+        tree[u].size = l_size + r_size + 1;
+        tree[u].height = (l_height > r_height ? l_height : r_height) + 1;
+    }
+};
+
+// 一层的节点数少于这个值时不值得分给多个线程，连续的若干小层由一个线程串行处理
+const int PARALLEL_LEVEL_MIN = 1 << 14;
+
 class BinaryTreeSolver {
 public:
     int n;
+    int root;    // 根节点编号，-1 表示空树
+    int threads; // 聚合时使用的线程数
+
+    // 层次序列：order[levelStart[d] .. levelStart[d+1]) 是第 d 层的全部节点
+    // 只算一次，层次遍历的输出和按层并行聚合共用
+    int* order;
+    int* levelStart;
+    int levels;
+
+    // Euler 序（前序展平）：整棵树按前序排进连续数组，任意子树都是其中连续的一段
+    // 以节点编号为下标：tin[u] 是 u 在前序中的位置，tout[u] 是它子树段的尾后位置
+    // 以前序位置为下标：pre[p] 是该位置的节点，其余数组都是这个位置上节点的信息
+    int* pre;
+    int* tin;
+    int* tout;
+    int* parentPos; // 父节点的前序位置，根为 -1
+    int* subSize;   // 子树大小
+
+    BinaryTreeSolver()
+        : n(0), root(-1), threads(1), order(nullptr), levelStart(nullptr), levels(0),
+          pre(nullptr), tin(nullptr), tout(nullptr), parentPos(nullptr), subSize(nullptr) {}
+
+    ~BinaryTreeSolver() {
+        delete[] tree;
+        delete[] order;
+        delete[] levelStart;
+        delete[] pre;
+        delete[] tin;
+        delete[] tout;
+        delete[] parentPos;
+        delete[] subSize;
+        tree = nullptr;
+    }
 
     // 读取输入并构建树
+    // 根节点不再假定为 1，而是在读入的同时找出来：
+    // 除根以外每个节点恰好作为孩子出现一次，所以
+    //   root = (1 ^ 2 ^ ... ^ n) ^ (所有非 -1 孩子编号的异或)
+    // 一遍扫描、O(1) 额外空间，不需要额外的“是否有父节点”标记数组
     void build() {
-        if (!(cin >> n)) return;
+        if (!(cin >> n) || n <= 0) {
+            n = 0;
+            return;
+        }
+        tree = new Node[n + 1];
+        int acc = 0;
         for (int i = 1; i <= n; ++i) {
             cin >> tree[i].left >> tree[i].right;
+            acc ^= i;
+            if (tree[i].left != -1) acc ^= tree[i].left;
+            if (tree[i].right != -1) acc ^= tree[i].right;
         }
+        root = acc;
     }
 
-    // 1. 前序遍历 (递归要求)
+    // 1. 前序遍历 (Morris 遍历，O(1) 额外空间)
     // 根->左->右
-    void preOrderRecursive(int u, bool isRoot = false) {
-        if (u == -1) return;
-        // 先输出根节点，再遍历左子树和右子树，一路向左遍历
-        // 向左遍历完后回溯到最近的右子树继续
-        // 格式控制：第一个数字前不加空格，后续加空格
-        // 但为了简化逻辑，通常输出每个数后跟空格，或者手动控制
-        // 这里为了严格匹配样例（通常行末空格是被允许的，但为了美观我们稍作控制）
-        // 实际上简单的 cout << u << " "; 即可
-        cout << u << " ";
-        
-        preOrderRecursive(tree[u].left);
-        preOrderRecursive(tree[u].right);
+    // 递归写法每层占一个栈帧，10^5 个节点的退化链就会把默认栈撑爆。
+    // Morris 遍历借用叶子上空着的 right 指针做“线索”：
+    // 进入左子树之前，把左子树最右节点（中序前驱）的 right 指向当前节点，
+    // 左子树走完后顺着线索回来，再把线索拆掉，树结构原样恢复。
+    // 每条边最多被走 3 次，总时间仍是 O(n)，不需要任何栈。
+    void preOrderMorris() {
+        int curr = root;
+        while (curr != -1) {
+            int l = tree[curr].left;
+            if (l == -1) {
+                cout << curr << " ";
+                curr = tree[curr].right;
+                continue;
+            }
+            // 找中序前驱：左子树中一路向右
+            int pre = l;
+            while (tree[pre].right != -1 && tree[pre].right != curr) {
+                pre = tree[pre].right;
+            }
+            if (tree[pre].right == -1) {
+                // 第一次到达：先输出根，再建立线索进入左子树
+                cout << curr << " ";
+                tree[pre].right = curr;
+                curr = l;
+            } else {
+                // 第二次到达（顺着线索回来）：左子树已处理完，拆掉线索转向右子树
+                tree[pre].right = -1;
+                curr = tree[curr].right;
+            }
+        }
+        cout << endl;
     }
 
     // 2. 中序遍历 (非递归要求)
     // 左->根->右
     void inOrderNonRecursive() {
-        MyStack s;
-        int curr = 1; // 根节点总是 1
+        MyStack s(n); // 栈深不超过树高，树高不超过 n
+        int curr = root;
 
         while (curr != -1 || !s.empty()) {
             // 一直向左走到底
@@ -99,74 +213,210 @@ public:
 
     // 3. 后序遍历 (非递归要求)
     // 左->右->根
-    // 技巧：使用双栈法。
-    // 逆序排列
-    // 栈1的遍历顺序是 根->左->右，改为 根->右->左 压入栈2
-    // 栈2弹出顺序即为 左->右->根
-    // 使用S1跑根、右、左顺序入S2
-    // S2出栈即为左、右、根顺序
-    // S1负责遍历，S2负责逆序输出
+    // 单栈法：和中序一样一路向左压栈；栈顶节点能否输出取决于它的右子树是否已经处理完。
+    // 用 last 记录上一个输出的节点：右孩子为空，或右孩子就是 last，说明右子树已完成。
+    // 以前的双栈法要把全部 n 个节点先倒进第二个栈再输出，这里栈深只等于树高。
     void postOrderNonRecursive() {
-        MyStack s1, s2;
-        s1.push(1); // 根节点
+        MyStack s(n);
+        int curr = root;
+        int last = -1;
 
-        while (!s1.empty()) {
-            int u = s1.pop();
-            s2.push(u);
+        while (curr != -1 || !s.empty()) {
+            while (curr != -1) {
+                s.push(curr);
+                curr = tree[curr].left;
+            }
+            int u = s.top();
+            int r = tree[u].right;
+            if (r != -1 && r != last) {
+                curr = r; // 右子树还没走，先处理右子树
+            } else {
+                cout << u << " ";
+                last = s.pop();
+            }
+        }
+        cout << endl;
+    }
 
-            // 注意：先压左再压右，这样在s1弹出的顺序就是 先右后左
-            // 放入s2的顺序就是 根->右->左
-            if (tree[u].left != -1) s1.push(tree[u].left);
-            if (tree[u].right != -1) s1.push(tree[u].right);
+    // 计算层次序列及每层的起点 (BFS)
+    // order 数组本身就充当队列：head 之前是已出队的节点，[head, tail) 是队列中的节点。
+    // 当 head 追上上一层的末尾时，队列里恰好是完整的下一层。
+    void buildLevels() {
+        if (order) return;
+        order = new int[n + 1];
+        levelStart = new int[n + 2];
+        levels = 0;
+        int head = 0, tail = 0;
+        if (root != -1) order[tail++] = root;
+        int levelEnd = 0;
+        while (head < tail) {
+            if (head == levelEnd) {
+                levelStart[levels++] = head;
+                levelEnd = tail;
+            }
+            int u = order[head++];
+            if (tree[u].left != -1) order[tail++] = tree[u].left;
+            if (tree[u].right != -1) order[tail++] = tree[u].right;
         }
+        levelStart[levels] = tail;
+    }
 
-        while (!s2.empty()) {
-            cout << s2.pop() << " ";
+    // 4. 层次遍历 (直接输出 BFS 求得的层次序列)
+    void levelOrder() {
+        buildLevels();
+        for (int i = 0; i < levelStart[levels]; ++i) {
+            cout << order[i] << " ";
         }
         cout << endl;
     }
 
-    // 4. 层次遍历 (使用队列)
-    void levelOrder() {
-        MyQueue q;
-        q.push(1); // 根节点
+    // 并行自底向上聚合：从最深的一层往上，逐层对本层所有节点调用 combine。
+    // 同一层的节点互不依赖（它们的孩子都在更深的层，已经算完），可以随意分给多个线程；
+    // 层与层之间用屏障隔开。大层均分给所有线程；连续的小层合并成一段交给 0 号线程串行处理，
+    // 避免退化链（每层 1 个节点、共 n 层）上每层都同步一次。
+    template <class Combine>
+    void aggregateBottomUp(const Combine& combine) {
+        buildLevels();
+        int T = threads;
+        if (T < 1 || n < PARALLEL_LEVEL_MIN) T = 1;
 
-        while (!q.empty()) {
-            int u = q.pop();
-            cout << u << " ";
+        // 处理 order[from, to) 这一段（可以跨越多层，只要按从深到浅的顺序）
+        auto runRange = [&](int from, int to) {
+            for (int i = to - 1; i >= from; --i) {
+                int u = order[i];
+                combine(u, tree[u].left, tree[u].right);
+            }
+        };
 
-            if (tree[u].left != -1) q.push(tree[u].left);
-            if (tree[u].right != -1) q.push(tree[u].right);
+        if (T == 1) {
+            // 层次序列倒过来就是“孩子一定在父亲之前”的顺序
+            runRange(0, levelStart[levels]);
+            return;
         }
-        cout << endl;
+
+        Barrier barrier(T);
+        auto worker = [&](int id) {
+            int d = levels - 1;
+            while (d >= 0) {
+                int cnt = levelStart[d + 1] - levelStart[d];
+                if (cnt >= PARALLEL_LEVEL_MIN) {
+                    // 大层：第 id 个线程负责其中连续的一段
+                    long long from = levelStart[d] + (long long)cnt * id / T;
+                    long long to = levelStart[d] + (long long)cnt * (id + 1) / T;
+                    runRange((int)from, (int)to);
+                    d--;
+                } else {
+                    // 向上合并连续的小层，整段由 0 号线程处理
+                    int top = d;
+                    while (top > 0 && levelStart[top] - levelStart[top - 1] < PARALLEL_LEVEL_MIN) top--;
+                    if (id == 0) runRange(levelStart[top], levelStart[d + 1]);
+                    d = top - 1;
+                }
+                barrier.wait();
+            }
+        };
+
+        thread* pool = new thread[T - 1];
+        for (int i = 1; i < T; ++i) pool[i - 1] = thread(worker, i);
+        worker(0);
+        for (int i = 1; i < T; ++i) pool[i - 1].join();
+        delete[] pool;
     }
 
-    // 计算子树大小和高度 (辅助函数，使用递归计算最简单)
-    // 返回值无所谓，直接修改全局 tree 数组
-    void calcMetrics(int u) {
-        if (u == -1) return;
+    // 计算子树大小和高度 (辅助函数)
+    // 后序遍历的思想：先算子节点，再算自己。结果直接写入全局 tree 数组
+    void calcMetrics() {
+        aggregateBottomUp(SizeHeightAgg());
+    }
 
-        int l = tree[u].left;
-        int r = tree[u].right;
+    // 构建 Euler 序 (一次性转换)
+    // 只有这一遍需要顺着 left/right 跳来跳去：用栈做前序，先压右孩子再压左孩子，
+    // 顺带记下父节点位置。子树大小随后由一遍倒序扫描得到：
+    // 倒过来的前序里孩子一定排在父亲前面，把自己的大小加到父亲位置上即可。
+    // 之后的各种查询都只访问这些连续数组。
+    void buildEuler() {
+        if (pre) return;
+        pre = new int[n + 1];
+        tin = new int[n + 1];
+        tout = new int[n + 1];
+        parentPos = new int[n + 1];
+        subSize = new int[n + 1];
+        if (root == -1) return;
 
-        // 后序遍历的思想：先算子节点，再算自己
-        calcMetrics(l);
-        calcMetrics(r);
+        // 栈里暂存的是节点编号；入栈前先把父位置写到 stagedParent[孩子] 处，
+        // 出栈时再搬到它真正的前序位置。
+        MyStack s(n);
+        int* stagedParent = tout; // tout 在扫描结束前用不到，借来暂存
+        stagedParent[root] = -1;
+        s.push(root);
+        int p = 0;
+        while (!s.empty()) {
+            int u = s.pop();
+            int parent = stagedParent[u];
+            pre[p] = u;
+            tin[u] = p;
+            parentPos[p] = parent;
+            if (tree[u].right != -1) {
+                stagedParent[tree[u].right] = p;
+                s.push(tree[u].right);
+            }
+            if (tree[u].left != -1) {
+                stagedParent[tree[u].left] = p;
+                s.push(tree[u].left);
+            }
+            p++;
+        }
 
-        int l_size = (l == -1) ? 0 : tree[l].size;
-        int r_size = (r == -1) ? 0 : tree[r].size;
-        
-        int l_height = (l == -1) ? 0 : tree[l].height;
-        int r_height = (r == -1) ? 0 : tree[r].height;
+        for (int i = 0; i < n; ++i) subSize[i] = 1;
+        for (int i = n - 1; i > 0; --i) subSize[parentPos[i]] += subSize[i];
+        for (int i = 0; i < n; ++i) tout[pre[i]] = i + subSize[i];
+    }
 
-        tree[u].size = l_size + r_size + 1;
-        tree[u].height = (l_height > r_height ? l_height : r_height) + 1;
+    // 以下查询都是 O(1) 算术或者对连续数组的顺序扫描，要求先调用 buildEuler()
+
+    // 子树 u 的节点数
+    int subtreeSize(int u) const { return tout[u] - tin[u]; }
+
+    // v 是否在 u 的子树中（含 u 自己）：v 的前序位置落在 u 的子树段内
+    bool inSubtree(int u, int v) const { return tin[u] <= tin[v] && tin[v] < tout[u]; }
+
+    // 输出子树 u 的前序序列：就是 pre 中连续的一段
+    void printSubtree(int u) {
+        for (int p = tin[u]; p < tout[u]; ++p) {
+            cout << pre[p] << " ";
+        }
+        cout << endl;
+    }
+
+    // 附加查询（可选）：树之后如果还有 q，则继续读 q 条查询，每条输出一行
+    //   1 u v : v 是否在 u 的子树中，输出 1 / 0
+    //   2 u   : 子树 u 的节点数
+    //   3 u   : 子树 u 的前序序列
+    // 编号不在 1~n 内的查询直接跳过、不输出；空树不处理查询
+    void answerQueries() {
+        if (root == -1) return;
+        int q;
+        if (!(cin >> q)) return;
+        buildEuler();
+        while (q-- > 0) {
+            int op, u, v = 1;
+            if (!(cin >> op >> u)) return;
+            if (op == 1) cin >> v;
+            if (u < 1 || u > n || v < 1 || v > n) continue;
+            if (op == 1) {
+                cout << (inSubtree(u, v) ? 1 : 0) << "\n";
+            } else if (op == 2) {
+                cout << subtreeSize(u) << "\n";
+            } else if (op == 3) {
+                printSubtree(u);
+            }
+        }
     }
 
     // 5 & 6. 输出统计数据
     void printMetrics() {
         // 先计算一遍所有节点的指标
-        calcMetrics(1);
+        calcMetrics();
 
         // 输出节点数 (按节点编号 1~n 顺序)
         for (int i = 1; i <= n; ++i) {
@@ -185,9 +435,8 @@ public:
     void solve() {
         build();
         
-        // 1. 前序 (递归)
-        preOrderRecursive(1);
-        cout << endl;
+        // 1. 前序 (Morris)
+        preOrderMorris();
         
         // 2. 中序 (非递归)
         inOrderNonRecursive();
@@ -200,15 +449,23 @@ public:
         
         // 5 & 6. 统计信息
         printMetrics();
+
+        // 附加的子树查询 (Euler 序)
+        answerQueries();
     }
 };
 
-int main() {
+// 命令行参数（可省略）：--threads N 指定聚合使用的线程数，默认取 CPU 核数
+int main(int argc, char* argv[]) {
     // 提高 IO 效率，量化/竞赛必备习惯
     ios::sync_with_stdio(false);
     cin.tie(0);
 
     BinaryTreeSolver solver;
+    solver.threads = (int)thread::hardware_concurrency();
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], "--threads") == 0) solver.threads = atoi(argv[i + 1]);
+    }
     solver.solve();
 
     return 0;
@@ -0,0 +1,478 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+using namespace std;
+
+// ============================================================
+// 持久化排名树 (Persistent Rank Tree) + 基于纪元的内存回收 (EBR)
+// ============================================================
+// BST_Rank_Ops.cpp 在内存池里原地修改节点，读者想在写者不停插入/删除的同时
+// 做一致的按名次查询，只能加锁。这里换成“路径复制”的持久化 AVL 树：
+//   * 写者修改时不动已发布的节点，而是把根到修改点的路径复制一份（O(log n) 个节点），
+//     在副本上完成插入/删除/旋转，最后用一次原子 store 发布新根；
+//   * 读者取出某一时刻的根，就得到一个永远不会再变的快照，整个查询不加锁、不重试；
+//   * 被替换掉的旧节点不能马上释放（可能还有读者在用），交给 EBR：
+//     写者把旧节点挂到当前纪元的回收链表上，所有活跃读者都进入新纪元之后，
+//     两个纪元之前的节点就不可能再被任何读者看到，可以安全复用。
+// 读者进入/退出各只有一次原子读和一次原子写，是 wait-free 的，
+// 读吞吐随核数线性增长，也不会阻塞写者（慢读者只会推迟回收，不会让写者等待）。
+//
+// 平衡规则与 BST_Rank_Ops.cpp 的 AVL 模式 (-DBST_BALANCE=2) 完全一致，
+// 所以 0~4 号操作的输出（xor_path）与它逐字节相同。
+//
+// 编译：g++ Persistent_Rank_Tree.cpp -o prt -O2 -pthread
+// 运行：./prt < input               按 BST_Rank_Ops 的格式处理操作
+//       ./prt --readers 8 < input   额外启动 8 个读线程并发做快照查询，吞吐输出到 stderr
+
+const int MAX_READERS = 64;
+
+struct PNode {
+    int val;
+    int size;   // 子树节点数
+    int height; // 子树高度
+    PNode* left;
+    PNode* right;
+    unsigned long long ver; // 创建该节点的写操作版本号；等于当前版本说明尚未发布，可以原地修改
+    PNode* nextFree;        // 在回收链表/空闲链表中时使用
+};
+
+struct OpResult {
+    bool ok;
+    int xorPath;
+};
+
+// -------------------- 节点分配器（只由写者线程使用） --------------------
+// 按块申请、空闲链表复用，与 BST_Rank_Ops.cpp 的 NodePool 同样的思路；
+// 块不会搬家，节点地址在整个生命周期内稳定，读者可以直接持有指针。
+class NodeAllocator {
+private:
+    static const int CHUNK = 1 << 16;
+    PNode** chunks;
+    int chunkCount;
+    int chunkCap;
+    int usedInChunk;
+    PNode* freeList;
+
+public:
+    NodeAllocator() : chunks(nullptr), chunkCount(0), chunkCap(0), usedInChunk(CHUNK), freeList(nullptr) {}
+
+    ~NodeAllocator() {
+        for (int i = 0; i < chunkCount; ++i) delete[] chunks[i];
+        delete[] chunks;
+    }
+
+    PNode* alloc() {
+        if (freeList) {
+            PNode* p = freeList;
+            freeList = p->nextFree;
+            return p;
+        }
+        if (usedInChunk == CHUNK) {
+            if (chunkCount == chunkCap) {
+                int newCap = chunkCap ? chunkCap * 2 : 16;
+                PNode** bigger = new PNode*[newCap];
+                if (chunkCount) memcpy(bigger, chunks, sizeof(PNode*) * chunkCount);
+                delete[] chunks;
+                chunks = bigger;
+                chunkCap = newCap;
+            }
+            chunks[chunkCount++] = new PNode[CHUNK];
+            usedInChunk = 0;
+        }
+        return &chunks[chunkCount - 1][usedInChunk++];
+    }
+
+    void release(PNode* p) {
+        p->nextFree = freeList;
+        freeList = p;
+    }
+};
+
+// -------------------- 持久化树 --------------------
+
+class PersistentRankTree {
+private:
+    // 每个读者独占一条 cache line，避免不同读者的纪元写入互相造成伪共享
+    struct alignas(64) ReaderSlot {
+        atomic<unsigned long long> epoch; // IDLE 表示当前不在读
+    };
+    static const unsigned long long IDLE = ~0ULL;
+
+    atomic<PNode*> root;                 // 已发布的最新版本
+    atomic<unsigned long long> globalEpoch;
+    ReaderSlot slots[MAX_READERS];
+    atomic<int> readerCount;
+
+    // 以下成员只有写者访问
+    NodeAllocator alloc;
+    unsigned long long curVer; // 当前写操作的版本号
+    PNode* limbo[3];           // 按 纪元 % 3 分组的待回收节点
+
+    static int sizeOf(const PNode* p) { return p ? p->size : 0; }
+    static int heightOf(const PNode* p) { return p ? p->height : 0; }
+
+    PNode* makeNode(int v) {
+        PNode* p = alloc.alloc();
+        p->val = v;
+        p->size = 1;
+        p->height = 1;
+        p->left = p->right = nullptr;
+        p->ver = curVer;
+        return p;
+    }
+
+    // 旧节点退休：本次写操作新建的节点从未发布，直接回收；
+    // 已发布的节点可能正被读者访问，挂到当前纪元的回收链表
+    void retire(PNode* p) {
+        if (p->ver == curVer) {
+            alloc.release(p);
+            return;
+        }
+        unsigned long long e = globalEpoch.load(memory_order_relaxed);
+        p->nextFree = limbo[e % 3];
+        limbo[e % 3] = p;
+    }
+
+    // 取得可以原地修改的节点：已经是本次新建的就直接用，否则复制一份并让旧节点退休
+    PNode* own(PNode* p) {
+        if (p->ver == curVer) return p;
+        PNode* c = alloc.alloc();
+        *c = *p;
+        c->ver = curVer;
+        retire(p);
+        return c;
+    }
+
+    static void pushUp(PNode* p) {
+        p->size = sizeOf(p->left) + sizeOf(p->right) + 1;
+        int lh = heightOf(p->left), rh = heightOf(p->right);
+        p->height = (lh > rh ? lh : rh) + 1;
+    }
+
+    // 旋转会改写孩子节点，所以孩子也要先 own
+    PNode* rotateRight(PNode* p) {
+        PNode* l = own(p->left);
+        p->left = l->right;
+        l->right = p;
+        pushUp(p);
+        pushUp(l);
+        return l;
+    }
+
+    PNode* rotateLeft(PNode* p) {
+        PNode* r = own(p->right);
+        p->right = r->left;
+        r->left = p;
+        pushUp(p);
+        pushUp(r);
+        return r;
+    }
+
+    // p 必须已经 own 过；规则与 BST_Rank_Ops.cpp 的 AVL maintain 相同
+    PNode* maintain(PNode* p) {
+        int diff = heightOf(p->left) - heightOf(p->right);
+        if (diff > 1) {
+            if (heightOf(p->left->left) < heightOf(p->left->right)) p->left = rotateLeft(own(p->left));
+            return rotateRight(p);
+        }
+        if (diff < -1) {
+            if (heightOf(p->right->right) < heightOf(p->right->left)) p->right = rotateRight(own(p->right));
+            return rotateLeft(p);
+        }
+        pushUp(p);
+        return p;
+    }
+
+    // 递归深度等于 AVL 树高（1.44 log n），不会有栈溢出的问题
+    PNode* insertRec(PNode* t, int v, OpResult& res) {
+        if (!t) {
+            res.ok = true;
+            return makeNode(v);
+        }
+        res.xorPath ^= t->val;
+        if (v == t->val) return t; // 已存在：不复制任何节点
+        PNode* c = (v < t->val) ? insertRec(t->left, v, res) : insertRec(t->right, v, res);
+        if (!res.ok) return t;
+        PNode* n = own(t);
+        if (v < n->val) n->left = c;
+        else n->right = c;
+        return maintain(n);
+    }
+
+    // 摘除子树最小节点，*minVal 带回它的值（后继替换，比较不计入 xorPath）
+    PNode* removeMin(PNode* t, int* minVal) {
+        if (!t->left) {
+            *minVal = t->val;
+            PNode* r = t->right;
+            retire(t);
+            return r;
+        }
+        PNode* n = own(t);
+        n->left = removeMin(n->left, minVal);
+        return maintain(n);
+    }
+
+    PNode* deleteNode(PNode* t) {
+        if (!t->left || !t->right) {
+            PNode* c = t->left ? t->left : t->right;
+            retire(t);
+            return c;
+        }
+        PNode* n = own(t);
+        int minVal;
+        n->right = removeMin(n->right, &minVal);
+        n->val = minVal;
+        return maintain(n);
+    }
+
+    PNode* removeRec(PNode* t, int v, OpResult& res) {
+        if (!t) return t;
+        res.xorPath ^= t->val;
+        if (v == t->val) {
+            res.ok = true;
+            return deleteNode(t);
+        }
+        PNode* c = (v < t->val) ? removeRec(t->left, v, res) : removeRec(t->right, v, res);
+        if (!res.ok) return t;
+        PNode* n = own(t);
+        if (v < n->val) n->left = c;
+        else n->right = c;
+        return maintain(n);
+    }
+
+    PNode* removeByRankRec(PNode* t, int k, OpResult& res) {
+        res.xorPath ^= t->val;
+        int leftSize = sizeOf(t->left);
+        if (k == leftSize + 1) {
+            res.ok = true;
+            return deleteNode(t);
+        }
+        PNode* n = own(t);
+        if (k <= leftSize) n->left = removeByRankRec(n->left, k, res);
+        else n->right = removeByRankRec(n->right, k - leftSize - 1, res);
+        return maintain(n);
+    }
+
+    // 写操作收尾：发布新根，然后尝试推进纪元并回收
+    void publish(PNode* newRoot) {
+        root.store(newRoot, memory_order_seq_cst);
+        tryAdvance();
+    }
+
+    // 所有活跃读者都已观察到当前纪元 e，才能推进到 e + 1；
+    // 推进后 (e + 1) % 3 号链表里是纪元 e - 2 退休的节点，已不可能被任何读者持有
+    void tryAdvance() {
+        unsigned long long e = globalEpoch.load(memory_order_relaxed);
+        int n = readerCount.load(memory_order_acquire);
+        for (int i = 0; i < n; ++i) {
+            unsigned long long r = slots[i].epoch.load(memory_order_seq_cst);
+            if (r != IDLE && r != e) return;
+        }
+        globalEpoch.store(e + 1, memory_order_seq_cst);
+        PNode* p = limbo[(e + 1) % 3];
+        limbo[(e + 1) % 3] = nullptr;
+        while (p) {
+            PNode* next = p->nextFree;
+            alloc.release(p);
+            p = next;
+        }
+    }
+
+    static OpResult searchIn(const PNode* p, int val) {
+        OpResult res = {false, 0};
+        while (p) {
+            res.xorPath ^= p->val;
+            if (val == p->val) {
+                res.ok = true;
+                break;
+            }
+            p = (val < p->val) ? p->left : p->right;
+        }
+        return res;
+    }
+
+    static OpResult searchByRankIn(const PNode* p, int k) {
+        OpResult res = {false, 0};
+        if (k < 1 || k > sizeOf(p)) return res;
+        while (true) {
+            res.xorPath ^= p->val;
+            int leftSize = sizeOf(p->left);
+            if (k == leftSize + 1) break;
+            if (k <= leftSize) {
+                p = p->left;
+            } else {
+                k -= leftSize + 1;
+                p = p->right;
+            }
+        }
+        res.ok = true;
+        return res;
+    }
+
+public:
+    // 读者快照：构造时登记纪元并取根，析构时退出。
+    // 快照存活期间看到的是构造那一刻的整棵树，写者的后续修改对它不可见。
+    class Snapshot {
+    private:
+        PersistentRankTree& tree;
+        int slot;
+        const PNode* snapRoot;
+
+    public:
+        Snapshot(PersistentRankTree& t, int readerId) : tree(t), slot(readerId) {
+            // 先公布自己所在的纪元，再读根：这样写者在推进纪元时一定能看到这个读者
+            unsigned long long e = tree.globalEpoch.load(memory_order_seq_cst);
+            tree.slots[slot].epoch.store(e, memory_order_seq_cst);
+            snapRoot = tree.root.load(memory_order_seq_cst);
+        }
+
+        ~Snapshot() {
+            tree.slots[slot].epoch.store(IDLE, memory_order_release);
+        }
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        int size() const { return sizeOf(snapRoot); }
+        OpResult search(int val) const { return searchIn(snapRoot, val); }
+        OpResult searchByRank(int k) const { return searchByRankIn(snapRoot, k); }
+    };
+
+    PersistentRankTree() : root(nullptr), globalEpoch(0), readerCount(0), curVer(0) {
+        for (int i = 0; i < MAX_READERS; ++i) slots[i].epoch.store(IDLE, memory_order_relaxed);
+        limbo[0] = limbo[1] = limbo[2] = nullptr;
+    }
+
+    PersistentRankTree(const PersistentRankTree&) = delete;
+    PersistentRankTree& operator=(const PersistentRankTree&) = delete;
+
+    // 每个读线程启动时调用一次，拿到自己的槽位编号；槽位用完返回 -1
+    int registerReader() {
+        int id = readerCount.fetch_add(1);
+        if (id >= MAX_READERS) {
+            readerCount.fetch_sub(1);
+            return -1;
+        }
+        return id;
+    }
+
+    // ---------- 写者接口（同一时刻只允许一个写线程） ----------
+    // 写者自己读最新版本不需要登记纪元：回收也是写者做的，不会和自己冲突
+
+    int size() const { return sizeOf(root.load(memory_order_relaxed)); }
+
+    OpResult insert(int val) {
+        OpResult res = {false, 0};
+        curVer++;
+        PNode* r = insertRec(root.load(memory_order_relaxed), val, res);
+        if (res.ok) publish(r);
+        return res;
+    }
+
+    OpResult search(int val) const {
+        return searchIn(root.load(memory_order_relaxed), val);
+    }
+
+    OpResult remove(int val) {
+        OpResult res = {false, 0};
+        curVer++;
+        PNode* r = removeRec(root.load(memory_order_relaxed), val, res);
+        if (res.ok) publish(r);
+        return res;
+    }
+
+    OpResult searchByRank(int k) const {
+        return searchByRankIn(root.load(memory_order_relaxed), k);
+    }
+
+    OpResult removeByRank(int k) {
+        OpResult res = {false, 0};
+        PNode* t = root.load(memory_order_relaxed);
+        if (k < 1 || k > sizeOf(t)) return res;
+        curVer++;
+        PNode* r = removeByRankRec(t, k, res);
+        publish(r);
+        return res;
+    }
+};
+
+// -------------------- 主函数 --------------------
+
+PersistentRankTree tree;
+atomic<bool> writerDone(false);
+atomic<long long> readerSink(0); // 汇总读线程的查询结果，防止查询被编译器优化掉
+
+// 读线程：反复取快照做随机的按名次查询，统计完成的查询次数
+void readerLoop(int id, long long* done) {
+    unsigned int seed = 2463534242u + id * 7919u;
+    long long cnt = 0;
+    long long sink = 0;
+    while (!writerDone.load(memory_order_relaxed)) {
+        PersistentRankTree::Snapshot snap(tree, id);
+        int n = snap.size();
+        for (int i = 0; i < 64; ++i) {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            OpResult r = snap.searchByRank(n ? (int)(seed % n) + 1 : 1);
+            sink += r.xorPath;
+        }
+        cnt += 64;
+    }
+    *done = cnt;
+    readerSink.fetch_add(sink);
+}
+
+int main(int argc, char* argv[]) {
+    int readers = 0;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], "--readers") == 0) readers = atoi(argv[i + 1]);
+    }
+    if (readers > MAX_READERS) readers = MAX_READERS;
+
+    thread* workers = readers ? new thread[readers] : nullptr;
+    long long* done = readers ? new long long[readers] : nullptr;
+    for (int i = 0; i < readers; ++i) {
+        int id = tree.registerReader();
+        done[i] = 0;
+        workers[i] = thread(readerLoop, id, &done[i]);
+    }
+
+    auto start = chrono::steady_clock::now();
+    int m;
+    if (scanf("%d", &m) == 1) {
+        while (m--) {
+            int op, val;
+            if (scanf("%d %d", &op, &val) != 2) break;
+
+            OpResult res = {false, 0};
+            if (op == 0) res = tree.insert(val);
+            else if (op == 1) res = tree.search(val);
+            else if (op == 2) res = tree.remove(val);
+            else if (op == 3) res = tree.searchByRank(val);
+            else if (op == 4) res = tree.removeByRank(val);
+
+            if (!res.ok) printf("0\n");
+            else printf("%d\n", res.xorPath);
+        }
+    }
+    writerDone.store(true);
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    long long total = 0;
+    for (int i = 0; i < readers; ++i) {
+        workers[i].join();
+        total += done[i];
+    }
+    if (readers) {
+        fprintf(stderr, "readers=%d snapshot_queries=%lld (%.1f M/s) writer_time=%.3fs\n",
+                readers, total, total / sec / 1e6, sec);
+    }
+    delete[] workers;
+    delete[] done;
+    return 0;
+}
@@ -1,71 +1,384 @@
 #include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <atomic>
+#include <thread>
+#include <mutex>
 
 using namespace std;
 
-const int MAXN = 100005;
+// 已知前序 + 中序，输出后序
+// 以前的写法是递归的 solve(preL, preR, inL, inR)：每深一层占一个栈帧，
+// 10^5 个节点的退化链就会栈溢出；另外 pos[val] 要求节点值本身能当数组下标（< MAXN）。
+// 现在改成：
+//   1. 用一个栈按前序顺序把树“挂”起来（下面 buildRange 的注释），全程只比较值是否相等，
+//      不需要“值 -> 中序下标”的索引，所以值可以是任意 64 位整数（仍要求互不相同）；
+//   2. 树用“前序下标”当节点编号存成静态链表，再用单栈迭代输出后序；
+//   3. 输出攒在缓冲区里整块写出，不再每个节点一次 cout。
+// 节点很多且指定了多线程时走并行分治（见 ParallelReconstructor），结果与串行完全相同。
+
+// ==========================================
+// 缓冲输出
+// ==========================================
+// 数字先转成字符写进缓冲区，满了或者结束时一次 fwrite
+struct FastWriter {
+    static const int BUF_SIZE = 1 << 16;
+    char buf[BUF_SIZE];
+    int len;
+
+    FastWriter() : len(0) {}
+    ~FastWriter() { flush(); }
+
+    void flush() {
+        if (len > 0) fwrite(buf, 1, len, stdout);
+        len = 0;
+    }
+
+    void putChar(char c) {
+        if (len == BUF_SIZE) flush();
+        buf[len++] = c;
+    }
+
+    void putInt(long long x) {
+        if (len + 24 > BUF_SIZE) flush();
+        // 用无符号数取反，LLONG_MIN 也不会溢出
+        unsigned long long u = (unsigned long long)x;
+        if (x < 0) {
+            buf[len++] = '-';
+            u = 0 - u;
+        }
+        char tmp[24];
+        int k = 0;
+        do {
+            tmp[k++] = (char)('0' + u % 10);
+            u /= 10;
+        } while (u != 0);
+        while (k > 0) buf[len++] = tmp[--k];
+    }
+};
 
 int n;
-int pre[MAXN]; // 存储前序序列
-int in[MAXN];  // 存储中序序列
-int pos[MAXN]; // 索引数组：pos[val] 表示数值 val 在中序序列中的下标
+long long* pre = nullptr; // 存储前序序列
+long long* in = nullptr;  // 存储中序序列
+// 节点编号就是它在前序中的下标 (0 ~ n-1)，-1 表示空
+int* lc = nullptr;
+int* rc = nullptr;
+// 建树和后序输出共用的栈。处理前序区间 [preL, preL+len) 时只用 stk[preL, preL+len)，
+// 栈深不超过区间长度，所以并行时各个任务的区间互不重叠，不需要各自分配
+int* stk = nullptr;
 
-// 递归函数：处理前序区间 [preL, preR] 和 中序区间 [inL, inR]
-// 目标是输出该区间的后序遍历
-void solve(int preL, int preR, int inL, int inR) {
-    // 递归基：区间无效时直接返回
-    if (preL > preR || inL > inR) {
-        return;
+// 由前序 + 中序建树 (栈式，O(len))，处理前序 [preL, preL+len) 与中序 [inL, inL+len)
+// 栈里保存“左链上还没确定右孩子的节点”。按前序依次处理每个节点 i：
+//   - 若栈顶恰好是中序当前应输出的节点 in[j]，说明栈顶的左子树已经结束，把它弹出、j++；
+//     连续弹出，最后一个被弹出的节点 parent 就是 i 的父亲，i 是它的右孩子；
+//   - 一个都没弹出，说明 i 还在栈顶的左子树里，i 是栈顶的左孩子。
+// 然后把 i 压栈。每个节点进栈、出栈各一次。返回子树根（就是 preL）。
+// 输入不是合法的前序/中序对时结果没有意义，但下标不会越界。
+int buildRange(int preL, int inL, int len) {
+    int* s = stk + preL;
+    int preR = preL + len;
+    int inR = inL + len;
+    for (int i = preL; i < preR; ++i) {
+        lc[i] = -1;
+        rc[i] = -1;
+    }
+    int top = 0;
+    int j = inL;
+    s[top++] = preL;
+    for (int i = preL + 1; i < preR; ++i) {
+        int parent = -1;
+        while (top > 0 && j < inR && pre[s[top - 1]] == in[j]) {
+            parent = s[--top];
+            j++;
+        }
+        if (parent != -1) {
+            rc[parent] = i;
+        } else if (top > 0) {
+            lc[s[top - 1]] = i;
+        }
+        s[top++] = i;
     }
+    return preL;
+}
 
-    // 1. 前序遍历的第一个是根节点
-    int rootVal = pre[preL];
+// 后序遍历 (单栈，左->右->根)，每输出一个节点调用一次 emit(值)
+// 与 BinaryTree_Traverse 中的写法相同：last 记录上一个输出的节点，
+// 右孩子为空或者就是 last，说明右子树已处理完，可以输出栈顶
+template <class Emit>
+void postOrderRange(int root, Emit& emit) {
+    int* s = stk + root; // 子树根就是区间左端，栈同样只用自己的区间
+    int top = 0;
+    int curr = root;
+    int last = -1;
+    while (curr != -1 || top > 0) {
+        while (curr != -1) {
+            s[top++] = curr;
+            curr = lc[curr];
+        }
+        int u = s[top - 1];
+        int r = rc[u];
+        if (r != -1 && r != last) {
+            curr = r;
+        } else {
+            emit(pre[u]);
+            last = u;
+            top--;
+        }
+    }
+}
 
-    // 2. 找到根节点在中序遍历中的位置 (使用预处理的数组 O(1) 查找)
-    int k = pos[rootVal];
+// ==========================================
+// 并行分治
+// ==========================================
+// 子问题 (preL, inL, len, outL)：前序 [preL, preL+len)、中序 [inL, inL+len) 描述同一棵子树，
+// 它的后序结果恰好占输出数组的 [outL, outL+len)。
+// 知道根在中序中的位置 k 之后，左子树大小 L = k - inL：
+//   左子树 -> (preL+1,   inL,   L,         outL)
+//   右子树 -> (preL+1+L, k+1,   len-1-L,   outL+L)
+//   根     -> 输出位置 outL+len-1
+// 每个子问题写的是输出数组里属于自己的一段，线程之间不需要任何同步。
+// 区间短于 PARALLEL_CUTOFF 时不再拆分，直接用上面的栈式算法串行处理。
 
-    // 3. 计算左子树的节点数量
-    // k 是根的下标，inL 是中序左边界，所以左边有 k - inL 个元素
-    int leftLen = k - inL;
+const int PARALLEL_CUTOFF = 1 << 15;
 
-    // 4. 递归处理左子树
-    // 前序范围：从根节点后移1位开始，长度为 leftLen
-    // 中序范围：从原来的左边界到根节点前一位
-    solve(preL + 1, preL + leftLen, inL, k - 1);
+struct Task {
+    int preL;
+    int inL;
+    int len;
+    int outL;
+};
 
-    // 5. 递归处理右子树
-    // 前序范围：排除掉根和左子树剩下的部分
-    // 中序范围：从根节点后一位到原来的右边界
-    solve(preL + leftLen + 1, preR, k + 1, inR);
+// 值 -> 中序下标 的哈希索引（开放定址，线性探测）
+// 只有在并行拆分时需要定位根，串行的栈式算法用不到
+struct PosIndex {
+    long long* keys;
+    int* vals; // -1 表示空槽
+    unsigned int mask;
 
-    // 6. 后序遍历要求：最后输出根节点
-    cout << rootVal << " ";
-}
+    PosIndex() : keys(nullptr), vals(nullptr), mask(0) {}
+    ~PosIndex() {
+        delete[] keys;
+        delete[] vals;
+    }
+
+    static unsigned long long mix(long long x) {
+        unsigned long long z = (unsigned long long)x + 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    void build(const long long* a, int cnt) {
+        unsigned int cap = 16;
+        while (cap < 2u * (unsigned int)cnt) cap <<= 1;
+        mask = cap - 1;
+        keys = new long long[cap];
+        vals = new int[cap];
+        for (unsigned int i = 0; i < cap; ++i) vals[i] = -1;
+        for (int i = 0; i < cnt; ++i) {
+            unsigned int h = (unsigned int)mix(a[i]) & mask;
+            while (vals[h] != -1 && keys[h] != a[i]) h = (h + 1) & mask;
+            keys[h] = a[i];
+            vals[h] = i;
+        }
+    }
+
+    int find(long long key) const {
+        unsigned int h = (unsigned int)mix(key) & mask;
+        while (vals[h] != -1) {
+            if (keys[h] == key) return vals[h];
+            h = (h + 1) & mask;
+        }
+        return -1;
+    }
+};
+
+// 工作窃取用的双端队列：自己从尾部压入/弹出（后进先出，局部性好），
+// 空闲线程从头部偷（偷到的是较早拆出来、通常也较大的子问题）。
+// 任务粒度在 PARALLEL_CUTOFF 以上，一把小锁的开销可以忽略
+struct WorkDeque {
+    mutex m;
+    Task* data;
+    int head;
+    int tail;
+    int cap;
+
+    WorkDeque() : data(new Task[64]), head(0), tail(0), cap(64) {}
+    ~WorkDeque() { delete[] data; }
+    WorkDeque(const WorkDeque&) = delete;
+    WorkDeque& operator=(const WorkDeque&) = delete;
 
-int main() {
+    void push(const Task& t) {
+        lock_guard<mutex> lock(m);
+        if (tail == cap) {
+            // 先把已被偷走的前半段挪掉，还不够再扩容
+            int cnt = tail - head;
+            if (cnt * 2 > cap) {
+                Task* bigger = new Task[cap * 2];
+                memcpy(bigger, data + head, sizeof(Task) * cnt);
+                delete[] data;
+                data = bigger;
+                cap *= 2;
+            } else {
+                memmove(data, data + head, sizeof(Task) * cnt);
+            }
+            head = 0;
+            tail = cnt;
+        }
+        data[tail++] = t;
+    }
+
+    bool popBack(Task& t) {
+        lock_guard<mutex> lock(m);
+        if (head == tail) return false;
+        t = data[--tail];
+        return true;
+    }
+
+    bool stealFront(Task& t) {
+        lock_guard<mutex> lock(m);
+        if (head == tail) return false;
+        t = data[head++];
+        return true;
+    }
+};
+
+class ParallelReconstructor {
+private:
+    long long* out;
+    PosIndex index;
+    WorkDeque* deques;
+    int threads;
+    atomic<int> pending; // 已创建但还没做完的任务数，归零时所有线程退出
+
+    // 串行处理一个小子问题：建树后把后序写到 out[outL, outL+len)
+    void solveLeaf(const Task& t) {
+        long long* dst = out + t.outL;
+        auto emit = [&](long long v) { *dst++ = v; };
+        postOrderRange(buildRange(t.preL, t.inL, t.len), emit);
+    }
+
+    // 沿左子树一路拆下去，右子树作为新任务放进自己的队列
+    void run(int id, Task t) {
+        while (t.len >= PARALLEL_CUTOFF) {
+            int k = index.find(pre[t.preL]);
+            if (k < t.inL || k >= t.inL + t.len) break; // 输入不合法，交给串行算法兜底
+            int L = k - t.inL;
+            int R = t.len - 1 - L;
+            out[t.outL + t.len - 1] = pre[t.preL];
+
+            Task left = {t.preL + 1, t.inL, L, t.outL};
+            Task right = {t.preL + 1 + L, k + 1, R, t.outL + L};
+            if (L == 0) {
+                t = right;
+            } else {
+                if (R > 0) {
+                    pending.fetch_add(1);
+                    deques[id].push(right);
+                }
+                t = left;
+            }
+        }
+        if (t.len > 0) solveLeaf(t);
+    }
+
+    void worker(int id) {
+        unsigned int seed = (unsigned int)id * 2654435761u + 1;
+        Task t;
+        while (pending.load() > 0) {
+            bool got = deques[id].popBack(t);
+            for (int tries = 0; !got && tries < threads; ++tries) {
+                seed = seed * 1103515245u + 12345u;
+                int victim = (int)((seed >> 16) % (unsigned int)threads);
+                if (victim != id) got = deques[victim].stealFront(t);
+            }
+            if (!got) {
+                this_thread::yield();
+                continue;
+            }
+            run(id, t);
+            pending.fetch_sub(1);
+        }
+    }
+
+public:
+    ParallelReconstructor(long long* dst, int threadCount)
+        : out(dst), deques(nullptr), threads(threadCount), pending(0) {}
+
+    ~ParallelReconstructor() { delete[] deques; }
+
+    void solve() {
+        index.build(in, n);
+        deques = new WorkDeque[threads];
+        pending.store(1);
+        deques[0].push(Task{0, 0, n, 0});
+
+        thread* pool = new thread[threads - 1];
+        for (int i = 1; i < threads; ++i) pool[i - 1] = thread(&ParallelReconstructor::worker, this, i);
+        worker(0);
+        for (int i = 1; i < threads; ++i) pool[i - 1].join();
+        delete[] pool;
+    }
+};
+
+// 命令行参数（可省略）：--threads N 指定线程数，默认取 CPU 核数；
+// 节点数不超过 PARALLEL_CUTOFF 或只有 1 个线程时走串行算法
+int main(int argc, char* argv[]) {
     // IO 加速，量化/竞赛大流量数据必备
     ios::sync_with_stdio(false);
     cin.tie(0);
 
+    int threads = (int)thread::hardware_concurrency();
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], "--threads") == 0) threads = atoi(argv[i + 1]);
+    }
+
     if (!(cin >> n)) return 0;
 
-    // 读取前序
-    for (int i = 1; i <= n; ++i) {
-        cin >> pre[i];
-    }
+    FastWriter out;
+    if (n > 0) {
+        pre = new long long[n];
+        in = new long long[n];
+        lc = new int[n];
+        rc = new int[n];
+        stk = new int[n];
 
-    // 读取中序，并记录每个值的位置
-    for (int i = 1; i <= n; ++i) {
-        cin >> in[i];
-        // 核心优化：记录数值 in[i] 出现的位置是 i
-        // 比如中序是 4 2 5...，则 pos[4]=1, pos[2]=2
-        pos[in[i]] = i; 
-    }
+        // 读取前序
+        for (int i = 0; i < n; ++i) {
+            cin >> pre[i];
+        }
+
+        // 读取中序
+        for (int i = 0; i < n; ++i) {
+            cin >> in[i];
+        }
 
-    // 开始递归求解
-    // 初始范围：前序 1~n，中序 1~n
-    solve(1, n, 1, n);
+        if (threads > 1 && n > PARALLEL_CUTOFF) {
+            long long* post = new long long[n];
+            ParallelReconstructor(post, threads).solve();
+            for (int i = 0; i < n; ++i) {
+                out.putInt(post[i]);
+                out.putChar(' ');
+            }
+            delete[] post;
+        } else {
+            auto emit = [&](long long v) {
+                out.putInt(v);
+                out.putChar(' ');
+            };
+            postOrderRange(buildRange(0, 0, n), emit);
+        }
 
-    cout << endl;
+        delete[] pre;
+        delete[] in;
+        delete[] lc;
+        delete[] rc;
+        delete[] stk;
+    }
+
+    out.putChar('\n');
+    out.flush();
 
     return 0;
-}
\ No newline at end of file
+}
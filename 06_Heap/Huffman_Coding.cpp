@@ -1,19 +1,43 @@
-/* 【程序功能】哈弗曼编码长度计算器
+/* 【程序功能】哈弗曼编码长度计算器 + 字节级哈弗曼压缩/解压
    【核心知识点】
       1. 字符串字符统计
       2. 手写最小堆 (Min-Heap) 实现优先队列
       3. 贪心算法 (Huffman Coding 逻辑)
+      4. 范式哈弗曼编码 (Canonical Huffman)、64 位位缓冲读写、查表解码
+   【用法】
+      无参数    ：读一行小写字母，输出哈弗曼编码总长度（原来的功能）
+      -c        ：把标准输入压缩后写到标准输出，默认按 256 KB 分块，各块独立
+                  --heap          用堆建树（作对照）
+                  --single        整份输入一张码表、一条码流（旧格式）
+                  --block-size K  块大小，单位 KB
+                  --threads N     线程数，默认取 CPU 核数
+      -d        ：把 -c 的输出解压回原文
+                  --threads N     线程数
+                  --block K       只解出第 K 块（从 0 开始）
 */
 
 #include <cstdio> // 引入C语言标准输入输出库 (比iostream更快)
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <thread>
+#include <atomic>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define HUF_POSIX_IO 1
+#endif
 
 // 使用 long long (简写为 ll) 防止数据溢出
 // 因为哈弗曼编码累加过程中的数字可能会很大，int (20亿) 可能不够用
 typedef long long ll;
+typedef unsigned long long ull;
+typedef unsigned char uchar;
 
 // --- 堆的全局变量定义 ---
 
-ll h[100];  // 堆数组：用来存放频率数据。因为是存26个字母，100个格子足够了
+ll h[600];  // 堆数组：用来存放频率数据。压缩时有 256 个字节值 + 255 个合并节点，600 个格子足够了
 int sz = 0; // 堆的大小：当前堆里存了多少个元素
 
 // --- 辅助函数：交换两个数 ---
@@ -79,24 +103,173 @@ ll top() {
     return h[1]; // 最小堆的性质：数组第 1 个位置永远是最小的
 }
 
-// --- 主函数 ---
-int main() {
+// --- 批量读入 ---
+// 以前逐字节 getchar()，每个字节都是一次带锁的 stdio 调用。现在：
+//   readSome()  一次读一大块（POSIX 下直接 read(0)，读终端时拿到一行就返回，不会傻等 EOF）
+//   openInput() 标准输入是普通文件时直接 mmap 整个文件，否则分块读进一个倍增的缓冲区
+size_t readSome(uchar* buf, size_t cap) {
+#ifdef HUF_POSIX_IO
+    while (true) {
+        ssize_t got = read(0, buf, cap);
+        if (got >= 0) return (size_t)got;
+        // 被信号打断就重试，其他错误按 EOF 处理
+        if (errno != EINTR) return 0;
+    }
+#else
+    return fread(buf, 1, cap, stdin);
+#endif
+}
+
+struct Input {
+    const uchar* data;
+    size_t len;
+    uchar* owned;  // 分块读入时的缓冲区，mmap 时为空
+    bool mapped;
+};
+
+Input openInput() {
+    Input in = {nullptr, 0, nullptr, false};
+#ifdef HUF_POSIX_IO
+    struct stat st;
+    if (fstat(0, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, 0, 0);
+        if (p != MAP_FAILED) {
+            madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+            in.data = (const uchar*)p;
+            in.len = (size_t)st.st_size;
+            in.mapped = true;
+            return in;
+        }
+    }
+#endif
+    size_t cap = 1 << 20;
+    uchar* buf = (uchar*)malloc(cap);
+    size_t len = 0;
+    while (true) {
+        if (len == cap) {
+            cap *= 2;
+            buf = (uchar*)realloc(buf, cap);
+        }
+        size_t got = readSome(buf + len, cap - len);
+        if (got == 0) break;
+        len += got;
+    }
+    in.data = buf;
+    in.len = len;
+    in.owned = buf;
+    return in;
+}
+
+void closeInput(Input& in) {
+#ifdef HUF_POSIX_IO
+    if (in.mapped) munmap((void*)in.data, in.len);
+#endif
+    free(in.owned);
+    in.data = nullptr;
+    in.owned = nullptr;
+}
+
+// --- 字节直方图 ---
+// 朴素的 freq[p[i]]++ 遇到连续相同的字节时，下一次自增要等上一次写回才能读，
+// 变成一条串行的“存-取”依赖链。这里用 8 张计数表轮流计数（第 i 个字节记进第 i%8 张表），
+// 相邻字节落在不同的表里，依赖链被拆成 8 条，最后再合并（8 张表共 8 KB，仍在 L1 内）。
+// 一次取 8 字节再拆开，省掉逐字节的载入；32 位计数器分段累加，每段不超过 2^30 字节，不会溢出。
+void histogramKernel(const uchar* p, size_t n, ll* freq) {
+    const size_t SEGMENT = (size_t)1 << 30;
+    unsigned int t[8][256];
+    while (n > 0) {
+        size_t len = n < SEGMENT ? n : SEGMENT;
+        memset(t, 0, sizeof(t));
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            ull w;
+            memcpy(&w, p + i, 8);
+            t[0][w & 0xff]++;
+            t[1][(w >> 8) & 0xff]++;
+            t[2][(w >> 16) & 0xff]++;
+            t[3][(w >> 24) & 0xff]++;
+            t[4][(w >> 32) & 0xff]++;
+            t[5][(w >> 40) & 0xff]++;
+            t[6][(w >> 48) & 0xff]++;
+            t[7][w >> 56]++;
+        }
+        for (; i < len; i++) t[0][p[i]]++;
+        for (int c = 0; c < 256; c++) {
+            freq[c] += (ll)t[0][c] + t[1][c] + t[2][c] + t[3][c] + t[4][c] + t[5][c] + t[6][c] + t[7][c];
+        }
+        p += len;
+        n -= len;
+    }
+}
+
+// 大输入切成 threads 段并行统计，各线程写自己的局部直方图，最后相加
+const size_t HIST_PARALLEL_MIN = (size_t)1 << 22; // 4 MB 以下线程开销不划算
+
+void histogram(const uchar* p, size_t n, ll* freq, int threads) {
+    for (int c = 0; c < 256; c++) freq[c] = 0;
+    if (threads <= 1 || n < HIST_PARALLEL_MIN) {
+        histogramKernel(p, n, freq);
+        return;
+    }
+    ll (*local)[256] = new ll[threads][256];
+    std::thread* pool = new std::thread[threads - 1];
+    auto work = [&](int t) {
+        size_t from = n / threads * t;
+        size_t to = (t == threads - 1) ? n : n / threads * (t + 1);
+        for (int c = 0; c < 256; c++) local[t][c] = 0;
+        histogramKernel(p + from, to - from, local[t]);
+    };
+    for (int t = 1; t < threads; t++) pool[t - 1] = std::thread(work, t);
+    work(0);
+    for (int t = 1; t < threads; t++) pool[t - 1].join();
+    for (int t = 0; t < threads; t++) {
+        for (int c = 0; c < 256; c++) freq[c] += local[t][c];
+    }
+    delete[] pool;
+    delete[] local;
+}
+
+// --- 原功能：编码长度计算 ---
+int lengthMode() {
     // 1. 统计频率
     ll freq[26] = {0}; // 存放26个字母的出现次数。freq[0]对应'a', freq[1]对应'b'...
-    char c;
     ll totalChars = 0; // 记录总共读入了多少个字符
-    
-    // 循环读取字符，直到遇到文件结束符(EOF)
-    while ((c = getchar()) != EOF) {
-        if (c >= 'a' && c <= 'z') {
-            // 如果是小写字母
-            freq[c - 'a']++; // 对应的计数器加 1
-            totalChars++;    // 总字符数加 1
-        } else if (c == '\n' && totalChars > 0) {
-            // 如果读到换行符，且前面已经读到过内容了，就结束输入
-            // (这是为了防止无限等待输入)
-            break;
+
+    // 按块读入，直到遇到文件结束符(EOF)。规则与逐字符读取时相同：
+    //   * 只统计小写字母，其他字符忽略
+    //   * 读到过字母之后遇到的第一个换行符处结束输入 (这是为了防止无限等待输入)
+    //   * 0xFF 字节也当作 EOF（以前用 char 接 getchar() 的返回值，0xFF 会被读成 -1）
+    // 每块先找出截止位置，再对截止位置之前的部分整体做直方图
+    static uchar buf[1 << 16];
+    ll cnt[256] = {0};
+    bool seen = false; // 是否已经读到过字母
+    size_t got;
+    while ((got = readSome(buf, sizeof(buf))) > 0) {
+        size_t end = got;
+        bool stop = false;
+        const void* ff = memchr(buf, 0xFF, got);
+        if (ff) {
+            end = (size_t)((const uchar*)ff - buf);
+            stop = true;
         }
+        size_t from = 0;
+        if (!seen) {
+            while (from < end && !(buf[from] >= 'a' && buf[from] <= 'z')) from++;
+            seen = from < end;
+        }
+        if (seen) {
+            const void* nl = memchr(buf + from, '\n', end - from);
+            if (nl) {
+                end = (size_t)((const uchar*)nl - buf);
+                stop = true;
+            }
+        }
+        histogramKernel(buf, end, cnt);
+        if (stop) break;
+    }
+    for (int i = 0; i < 26; i++) {
+        freq[i] = cnt['a' + i];
+        totalChars += freq[i];
     }
 
     // 2. 将统计好的频率放入堆中
@@ -140,4 +313,807 @@ int main() {
     printf("%lld\n", totalLength);
 
     return 0;
-}
\ No newline at end of file
+}
+
+// ======================================================================
+// 字节级哈弗曼压缩 (-c / -d)
+// ======================================================================
+// 压缩文件格式（整数均为小端）：
+//   单流 (-c --single)：
+//     "HUF1" | 原文长度 (8 字节) | 256 个码长 (每个 1 字节, 0 表示没出现) | 码流
+//   分块 (-c 默认)：
+//     "HUF2" | 原文长度 (8 字节) | 块大小 (4 字节) | 块数 (4 字节)
+//     | 块偏移索引 (块数+1 个 8 字节，相对数据区起点，最后一个是数据区总长)
+//     | 数据区：每块 = 128 字节码长（每个符号 4 位，高半字节在前）
+//                    + 前三条码流的字节数 (3 个 4 字节) + 四条码流
+//       块内原文均分成四段，每段一条码流，解压时四条交错解码
+// 码流按范式编码、高位在前依次排列，末尾补 0 到整字节。
+// 只存码长就够了：范式编码下，码长确定后每个符号的码字是唯一确定的，
+// 解码端按同样的规则重新分配即可。
+// 分块格式里每块有自己的码表、从整字节开始，块与块之间完全独立：
+// 可以多线程同时压缩/解压，也可以借助索引只解出其中一块（-d --block K）。
+
+const int SYMBOLS = 256;
+const int MAX_CODE_LEN = 24;   // 解码端接受的码长上限：位缓冲一次至少能补到 57 位，24 位的码绰绰有余
+const int TABLE_BITS = 12;     // 一级解码表的索引位数，与压缩端的码长上限相同，新码流总能一次查表解出
+const int HEADER_SIZE = 4 + 8 + SYMBOLS;
+
+// --- 由频率求码长 ---
+// 两种建树方法给出的都是最优（不限长）的码长，写进 len[]，返回最大码长：
+//   huffmanLengthsTwoQueue：频率排好序后用两个队列，O(n) 合并，压缩时默认用它
+//   huffmanLengthsHeap    ：用上面的堆逐次取最小，留作对照（-c --heap 使用）
+// 两者在频率相同时的合并顺序不同，码长可能不一样，但总长度相同。
+// 码长超过 CODE_LEN_LIMIT 时再用 package-merge 求限长下的最优码长。
+const int CODE_LEN_LIMIT = 12; // 压缩时的码长上限，解码表 2^12 项 x 4 字节 = 16 KB，放得进 L1
+
+// 由“父节点编号”数组求叶子深度：合并出来的内部节点从 SYMBOLS 开始编号，
+// 父节点编号总比孩子大，所以按编号从大到小扫一遍就能由父亲的深度推出孩子的深度
+int depthsFromParents(const ll* freq, const int* parent, int root, int* len) {
+    int depth[2 * SYMBOLS];
+    depth[root] = 0;
+    int maxLen = 0;
+    for (int v = root - 1; v >= 0; v--) {
+        if (v < SYMBOLS && freq[v] == 0) continue;
+        depth[v] = depth[parent[v]] + 1;
+        if (v < SYMBOLS) {
+            len[v] = depth[v];
+            if (depth[v] > maxLen) maxLen = depth[v];
+        }
+    }
+    return maxLen;
+}
+
+// 堆里放 (频率 << 9) | 节点号：频率小的在前，频率相同时节点号小的在前，弹出后低 9 位就是节点号
+// 调用前已保证至少有两种符号
+int huffmanLengthsHeap(const ll* freq, int* len) {
+    int parent[2 * SYMBOLS];
+    sz = 0;
+    for (int i = 0; i < SYMBOLS; i++) {
+        if (freq[i] > 0) push((freq[i] << 9) | i);
+    }
+    int next = SYMBOLS;
+    while (sz > 1) {
+        ll a = top(); pop();
+        ll b = top(); pop();
+        parent[a & 511] = next;
+        parent[b & 511] = next;
+        push((((a >> 9) + (b >> 9)) << 9) | next);
+        next++;
+    }
+    return depthsFromParents(freq, parent, next - 1, len);
+}
+
+// 出现过的符号按 (频率, 符号) 升序排好，写进 order，返回个数
+// 最多 256 个元素，直接插入排序
+int sortSymbols(const ll* freq, int* order) {
+    int m = 0;
+    for (int i = 0; i < SYMBOLS; i++) {
+        if (freq[i] == 0) continue;
+        int k = m++;
+        while (k > 0 && freq[order[k - 1]] > freq[i]) {
+            order[k] = order[k - 1];
+            k--;
+        }
+        order[k] = i;
+    }
+    return m;
+}
+
+// 两个队列：叶子队列是排好序的符号；合并出来的新节点权值单调不减，
+// 按产生顺序排进第二个队列，本身就是有序的。每次从两个队首里取较小的，不需要堆。
+int huffmanLengthsTwoQueue(const ll* freq, int* len) {
+    int order[SYMBOLS];
+    int m = sortSymbols(freq, order);
+    int parent[2 * SYMBOLS];
+    ll weight[2 * SYMBOLS]; // 内部节点的权值，下标为节点号
+    int leafHead = 0;
+    int innerHead = SYMBOLS, innerTail = SYMBOLS; // 内部节点队列就是编号区间 [innerHead, innerTail)
+
+    // 取出两个队首中较小的一个（相等时优先取叶子，树更矮）
+    auto takeMin = [&](ll& w) {
+        if (leafHead < m && (innerHead == innerTail || freq[order[leafHead]] <= weight[innerHead])) {
+            w = freq[order[leafHead]];
+            return order[leafHead++];
+        }
+        w = weight[innerHead];
+        return innerHead++;
+    };
+
+    for (int k = 0; k < m - 1; k++) {
+        ll wa, wb;
+        int a = takeMin(wa);
+        int b = takeMin(wb);
+        parent[a] = innerTail;
+        parent[b] = innerTail;
+        weight[innerTail] = wa + wb;
+        innerTail++;
+    }
+    return depthsFromParents(freq, parent, innerTail - 1, len);
+}
+
+// package-merge：码长不超过 limit 的最优前缀码 (m 个符号要求 2^limit >= m)
+// 把每个符号看成面值 2^-1 ... 2^-limit 各一枚、价值为频率的硬币，
+// 凑出总面值 m-1 的最便宜方案，符号的码长就是它被选中的硬币枚数。做法：
+//   最深一层的列表就是排好序的符号；往上每一层，把下一层相邻两项打包成一项（权值相加），
+//   再和排好序的符号归并。最上一层取最小的 2m-2 项。
+//   被选中的项在每层都是列表的前缀，其中打包项有 p 个，就说明下一层的前 2p 项也被选中；
+//   逐层往下数，每遇到一个被选中的符号，它的码长 +1。
+// 时间 O(m * limit)。
+void packageMerge(const ll* freq, int limit, int* len) {
+    // 约 74 KB，放在栈上，多个线程同时调用也互不干扰
+    ll w[CODE_LEN_LIMIT + 1][2 * SYMBOLS];
+    int sym[CODE_LEN_LIMIT + 1][2 * SYMBOLS]; // -1 表示打包项
+    int size[CODE_LEN_LIMIT + 1];
+    int order[SYMBOLS];
+    int m = sortSymbols(freq, order);
+
+    for (int k = 0; k < m; k++) {
+        w[limit][k] = freq[order[k]];
+        sym[limit][k] = order[k];
+    }
+    size[limit] = m;
+    for (int j = limit - 1; j >= 1; j--) {
+        int packs = size[j + 1] / 2;
+        int a = 0, b = 0, t = 0;
+        while (a < m || b < packs) {
+            ll pw = (b < packs) ? w[j + 1][2 * b] + w[j + 1][2 * b + 1] : 0;
+            if (a < m && (b >= packs || freq[order[a]] <= pw)) {
+                w[j][t] = freq[order[a]];
+                sym[j][t] = order[a];
+                a++;
+            } else {
+                w[j][t] = pw;
+                sym[j][t] = -1;
+                b++;
+            }
+            t++;
+        }
+        size[j] = t;
+    }
+
+    for (int i = 0; i < SYMBOLS; i++) len[i] = 0;
+    int take = 2 * m - 2;
+    for (int j = 1; j <= limit; j++) {
+        int packs = 0;
+        for (int t = 0; t < take; t++) {
+            if (sym[j][t] >= 0) len[sym[j][t]]++;
+            else packs++;
+        }
+        take = 2 * packs;
+    }
+}
+
+// 压缩用的码长：先求不限长的最优码长，超过 CODE_LEN_LIMIT 再改用 package-merge
+void buildCodeLengths(const ll* freq, uchar* out, bool useHeap) {
+    int len[SYMBOLS];
+    int used = 0;
+    for (int i = 0; i < SYMBOLS; i++) {
+        len[i] = 0;
+        if (freq[i] > 0) used++;
+    }
+    if (used == 1) {
+        // 只有一种字节：给它 1 位长的码（与原功能里“单字符按 1 位算”一致）
+        for (int i = 0; i < SYMBOLS; i++) len[i] = (freq[i] > 0) ? 1 : 0;
+    } else if (used > 1) {
+        int maxLen = useHeap ? huffmanLengthsHeap(freq, len) : huffmanLengthsTwoQueue(freq, len);
+        if (maxLen > CODE_LEN_LIMIT) packageMerge(freq, CODE_LEN_LIMIT, len);
+    }
+    for (int i = 0; i < SYMBOLS; i++) out[i] = (uchar)len[i];
+}
+
+// --- 范式编码 ---
+// 按 (码长, 符号) 从小到大依次分配码字：同一码长内码字连续递增，
+// 换到更长的码长时先 +1 再左移。code[i] 是符号 i 的码字（右对齐）。
+// 顺带给出解码用的信息：
+//   sorted[]      按 (码长, 符号) 排好的符号表
+//   firstCode[l]  长度为 l 的第一个码字
+//   offset[l]     长度为 l 的第一个符号在 sorted 中的下标
+//   count[l]      长度为 l 的符号个数
+struct Canonical {
+    unsigned int code[SYMBOLS];
+    uchar len[SYMBOLS];
+    uchar sorted[SYMBOLS];
+    unsigned int firstCode[MAX_CODE_LEN + 2];
+    int offset[MAX_CODE_LEN + 2];
+    int count[MAX_CODE_LEN + 2];
+    int maxLen;
+
+    // 码长不合法（超过上限，或者不满足 Kraft 不等式）时返回 false
+    bool assign(const uchar* lengths) {
+        for (int l = 0; l <= MAX_CODE_LEN + 1; l++) count[l] = 0;
+        maxLen = 0;
+        for (int i = 0; i < SYMBOLS; i++) {
+            len[i] = lengths[i];
+            if (len[i] > MAX_CODE_LEN) return false;
+            count[len[i]]++;
+            if (len[i] > maxLen) maxLen = len[i];
+        }
+        count[0] = 0;
+        // 计数排序：按码长分桶，桶内符号自然是升序
+        int idx = 0;
+        for (int l = 1; l <= MAX_CODE_LEN; l++) {
+            offset[l] = idx;
+            for (int i = 0; i < SYMBOLS; i++) {
+                if (len[i] == l) sorted[idx++] = (uchar)i;
+            }
+        }
+        unsigned int c = 0;
+        for (int l = 1; l <= MAX_CODE_LEN; l++) {
+            c = (c + (unsigned int)count[l - 1]) << 1;
+            firstCode[l] = c;
+            if ((ull)c + count[l] > (1ull << l)) return false;
+        }
+        for (int l = 1; l <= MAX_CODE_LEN; l++) {
+            for (int k = 0; k < count[l]; k++) {
+                code[sorted[offset[l] + k]] = firstCode[l] + (unsigned int)k;
+            }
+        }
+        return true;
+    }
+};
+
+// --- 64 位位缓冲写入 ---
+// 码字从低位拼进 acc，攒够 32 位就按高位在前一次写出 4 个字节
+struct BitWriter {
+    uchar* out;
+    size_t pos;
+    ull acc;
+    int bits;
+
+    explicit BitWriter(uchar* dst) : out(dst), pos(0), acc(0), bits(0) {}
+
+    void put(unsigned int code, int len) {
+        acc = (acc << len) | code;
+        bits += len;
+        if (bits >= 32) {
+            unsigned int w = (unsigned int)(acc >> (bits - 32));
+            out[pos] = (uchar)(w >> 24);
+            out[pos + 1] = (uchar)(w >> 16);
+            out[pos + 2] = (uchar)(w >> 8);
+            out[pos + 3] = (uchar)w;
+            pos += 4;
+            bits -= 32;
+        }
+    }
+
+    // 写出剩余不足 32 位的部分，末尾补 0
+    void finish() {
+        while (bits >= 8) {
+            out[pos++] = (uchar)(acc >> (bits - 8));
+            bits -= 8;
+        }
+        if (bits > 0) {
+            out[pos++] = (uchar)(acc << (8 - bits));
+            bits = 0;
+        }
+    }
+};
+
+// 按大端取 8 个字节
+inline ull load64BE(const uchar* p) {
+#if defined(__GNUC__)
+    ull v;
+    memcpy(&v, p, 8);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+#else
+    ull v = 0;
+    for (int i = 0; i < 8; i++) v = (v << 8) | p[i];
+    return v;
+#endif
+}
+
+// --- 64 位位缓冲读取 ---
+// buf 左对齐：最高位是下一个要读的位，avail 是其中有效的位数。
+// refill 一次补 8 字节（大端拼接），保证 avail >= 56；读过输入末尾时补 0，
+// 解码端按原文长度控制符号个数，正常情况下补的 0 不会被用到；
+// 用到了说明码流被截断，overrun() 可以查出来。
+struct BitReader {
+    const uchar* p;
+    const uchar* end;
+    ull buf;
+    int avail;
+    int padBits; // 读过末尾后补进来的 0 的位数
+
+    BitReader(const uchar* src, const uchar* srcEnd) : p(src), end(srcEnd), buf(0), avail(0), padBits(0) { refill(); }
+
+    void refill() {
+        if (end - p >= 8) {
+            refillFast();
+        } else {
+            while (avail <= 56) {
+                ull byte = 0;
+                if (p < end) byte = *p++;
+                else padBits += 8;
+                buf |= byte << (56 - avail);
+                avail += 8;
+            }
+        }
+    }
+
+    // 调用方保证后面至少还有 8 个字节，没有边界判断
+    void refillFast() {
+        buf |= load64BE(p) >> avail;
+        int take = (63 - avail) >> 3;
+        p += take;
+        avail += take * 8;
+    }
+
+    unsigned int peek(int k) const { return (unsigned int)(buf >> (64 - k)); }
+
+    void skip(int k) {
+        buf <<= k;
+        avail -= k;
+    }
+
+    // 是否已经消耗了补进来的 0（即码流比声明的原文短）
+    bool overrun() const { return avail < padBits; }
+};
+
+// --- 查表解码 ---
+// 一级表以接下来的 TABLE_BITS 位为下标，每项 32 位：
+//   bits 0-7  第一个符号     bits 8-15  第二个符号
+//   bits 16-17 本项解出的符号数 (0/1/2)
+//   bits 20-23 第一个符号的码长   bits 24-28 两个符号合计的码长
+// 短码的符号大多一次能解出两个；符号数为 0 表示码长超过 TABLE_BITS，
+// 走范式编码的逐长度比较。压缩端把码长限制在 TABLE_BITS 以内，
+// 慢路径只在解码码长上限更宽的旧码流时才会用到。
+struct Decoder {
+    Canonical canon;
+    unsigned int table[1 << TABLE_BITS];
+    bool complete; // 表中每一项都能直接解出符号（码长不超过 TABLE_BITS 且码是满的）
+
+    // 在 bits（左对齐到 width 位）中解出第一个码长不超过 width 的符号；解不出返回 false
+    bool decodeOne(unsigned int bits, int width, int& sym, int& len) const {
+        for (int l = 1; l <= width && l <= canon.maxLen; l++) {
+            if (canon.count[l] == 0) continue;
+            unsigned int c = bits >> (width - l);
+            if (c - canon.firstCode[l] < (unsigned int)canon.count[l]) {
+                sym = canon.sorted[canon.offset[l] + (c - canon.firstCode[l])];
+                len = l;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool init(const uchar* lengths) {
+        if (!canon.assign(lengths)) return false;
+        // 先建单符号表：码长 l 的码字占满以它开头的 2^(TABLE_BITS-l) 项，每项 = 符号 | 码长 << 8
+        const unsigned int MASK = (1u << TABLE_BITS) - 1;
+        unsigned short single[1 << TABLE_BITS];
+        memset(single, 0, sizeof(single));
+        for (int l = 1; l <= TABLE_BITS && l <= canon.maxLen; l++) {
+            int span = 1 << (TABLE_BITS - l);
+            for (int k = 0; k < canon.count[l]; k++) {
+                int sym = canon.sorted[canon.offset[l] + k];
+                unsigned int from = canon.code[sym] << (TABLE_BITS - l);
+                for (int j = 0; j < span; j++) single[from + j] = (unsigned short)(sym | (l << 8));
+            }
+        }
+        // 再拼第二个符号：剩下的位左移补 0 后查单符号表，码长不超过剩余位数才算完整解出
+        complete = true;
+        for (unsigned int idx = 0; idx <= MASK; idx++) {
+            unsigned int first = single[idx];
+            int l1 = (int)(first >> 8);
+            if (l1 == 0) {
+                table[idx] = 0;
+                complete = false;
+                continue;
+            }
+            unsigned int e = (first & 255) | (1u << 16) | ((unsigned int)l1 << 20) | ((unsigned int)l1 << 24);
+            unsigned int second = single[(idx << l1) & MASK];
+            int l2 = (int)(second >> 8);
+            if (l2 != 0 && l1 + l2 <= TABLE_BITS) {
+                e = (first & 255) | ((second & 255) << 8) | (2u << 16) |
+                    ((unsigned int)l1 << 20) | ((unsigned int)(l1 + l2) << 24);
+            }
+            table[idx] = e;
+        }
+        return true;
+    }
+
+    // 慢路径：长码逐个长度比较
+    int decodeLong(BitReader& br) const {
+        int sym, len;
+        if (!decodeOne(br.peek(MAX_CODE_LEN), MAX_CODE_LEN, sym, len)) return -1; // 码流损坏
+        br.skip(len);
+        return sym;
+    }
+
+    // 从 br 接着解出 n 个符号写到 out；码流损坏时返回 false
+    bool decodeStream(BitReader& br, uchar* out, size_t n) const {
+        size_t i = 0;
+        while (i < n) {
+            if (br.avail < MAX_CODE_LEN + TABLE_BITS) br.refill();
+            unsigned int e = table[br.peek(TABLE_BITS)];
+            unsigned int cnt = (e >> 16) & 3;
+            if (cnt == 2 && i + 1 < n) {
+                out[i] = (uchar)e;
+                out[i + 1] = (uchar)(e >> 8);
+                i += 2;
+                br.skip((int)(e >> 24));
+            } else if (cnt != 0) {
+                out[i++] = (uchar)e;
+                br.skip((int)((e >> 20) & 15));
+            } else {
+                int s = decodeLong(br);
+                if (s < 0) return false;
+                out[i++] = (uchar)s;
+            }
+        }
+        return true;
+    }
+
+    bool decode(const uchar* src, const uchar* srcEnd, uchar* out, size_t n) const {
+        BitReader br(src, srcEnd);
+        return decodeStream(br, out, n) && !br.overrun();
+    }
+
+    // 四路交错解码：四条码流各自对应输出的四分之一，在同一个循环里轮流查表。
+    // 单条码流的每一步都要等上一步算出位置才能查下一项，是一条串行依赖链；
+    // 四条链互不相干，CPU 可以让它们的查表和移位重叠执行。
+    // 快路径每步固定写两个字节、按项里的符号数前进，没有分支；
+    // 剩余量不足一轮时（以及码表不满的少见情况）交给 decodeStream 收尾
+    bool decode4(BitReader* br, uchar** out, uchar** outEnd) const {
+        if (complete) {
+            while (true) {
+                // 每轮每条流走 4 步：最多写 8 个字节、读 48 位。
+                // 按输出和输入两边最紧的那条流算出能放心走的轮数，轮内不再做任何边界判断
+                size_t room = (size_t)-1;
+                size_t input = (size_t)-1;
+                for (int k = 0; k < 4; k++) {
+                    size_t r = (size_t)(outEnd[k] - out[k]);
+                    if (r < room) room = r;
+                    r = (size_t)(br[k].end - br[k].p);
+                    if (r < input) input = r;
+                }
+                size_t rounds = room / 8;
+                // refillFast 要求后面还有 8 个字节；每轮读指针最多前进 6 字节
+                size_t inRounds = input >= 16 ? (input - 16) / 6 + 1 : 0;
+                if (inRounds < rounds) rounds = inRounds;
+                if (rounds == 0) break;
+                // 读指针和位缓冲拷成局部变量：写 uchar 会被编译器当作可能改到任何内存，
+                // 留在数组里的话每步都要重新从内存读回来
+                uchar* o0 = out[0];
+                uchar* o1 = out[1];
+                uchar* o2 = out[2];
+                uchar* o3 = out[3];
+                BitReader b0 = br[0], b1 = br[1], b2 = br[2], b3 = br[3];
+                for (size_t r = 0; r < rounds; r++) {
+                    b0.refillFast();
+                    b1.refillFast();
+                    b2.refillFast();
+                    b3.refillFast();
+                    // refill 后至少有 56 位，够连走 4 步（每步不超过 TABLE_BITS 位）
+                    for (int step = 0; step < 4; step++) {
+                        unsigned int e0 = table[b0.peek(TABLE_BITS)];
+                        unsigned int e1 = table[b1.peek(TABLE_BITS)];
+                        unsigned int e2 = table[b2.peek(TABLE_BITS)];
+                        unsigned int e3 = table[b3.peek(TABLE_BITS)];
+                        o0[0] = (uchar)e0; o0[1] = (uchar)(e0 >> 8); o0 += (e0 >> 16) & 3;
+                        o1[0] = (uchar)e1; o1[1] = (uchar)(e1 >> 8); o1 += (e1 >> 16) & 3;
+                        o2[0] = (uchar)e2; o2[1] = (uchar)(e2 >> 8); o2 += (e2 >> 16) & 3;
+                        o3[0] = (uchar)e3; o3[1] = (uchar)(e3 >> 8); o3 += (e3 >> 16) & 3;
+                        b0.skip((int)(e0 >> 24));
+                        b1.skip((int)(e1 >> 24));
+                        b2.skip((int)(e2 >> 24));
+                        b3.skip((int)(e3 >> 24));
+                    }
+                }
+                br[0] = b0;
+                br[1] = b1;
+                br[2] = b2;
+                br[3] = b3;
+                out[0] = o0;
+                out[1] = o1;
+                out[2] = o2;
+                out[3] = o3;
+            }
+        }
+        for (int k = 0; k < 4; k++) {
+            if (!decodeStream(br[k], out[k], (size_t)(outEnd[k] - out[k]))) return false;
+            if (br[k].overrun()) return false;
+        }
+        return true;
+    }
+};
+
+// --- 小端整数读写 ---
+void putLE(uchar* p, ull v, int bytes) {
+    for (int k = 0; k < bytes; k++) p[k] = (uchar)(v >> (8 * k));
+}
+
+ull getLE(const uchar* p, int bytes) {
+    ull v = 0;
+    for (int k = bytes - 1; k >= 0; k--) v = (v << 8) | p[k];
+    return v;
+}
+
+// --- 单块编码/解码 ---
+// 码流部分的最坏长度：压缩端的码长不超过 CODE_LEN_LIMIT，每个字节最多这么多位，
+// 再加上 BitWriter 一次写 4 字节的余量。（MAX_CODE_LEN 只是解码端的接受上限，按它算会多占一倍内存）
+size_t streamBound(size_t n) {
+    return n / 8 * CODE_LEN_LIMIT + CODE_LEN_LIMIT + 8;
+}
+
+// 按给定码表把 src 编码到 dst，返回写出的字节数
+size_t encodeStream(const Canonical& canon, const uchar* src, size_t n, uchar* dst) {
+    BitWriter bw(dst);
+    for (size_t i = 0; i < n; i++) {
+        bw.put(canon.code[src[i]], canon.len[src[i]]);
+    }
+    bw.finish();
+    return bw.pos;
+}
+
+const int BLOCK_TABLE_SIZE = SYMBOLS / 2; // 块头：每个码长 4 位
+const int BLOCK_HEADER_SIZE = BLOCK_TABLE_SIZE + 3 * 4; // 再加前三条码流的长度
+const size_t DEFAULT_BLOCK_SIZE = (size_t)256 << 10;
+
+// 块内分成四段，前三段各 ceil(n/4) 字节，最后一段取剩下的
+void splitQuarters(size_t n, size_t* from) {
+    size_t q = (n + 3) / 4;
+    for (int k = 0; k < 4; k++) from[k] = (q * k < n) ? q * k : n;
+    from[4] = n;
+}
+
+size_t blockBound(size_t n) {
+    return BLOCK_HEADER_SIZE + 4 * streamBound((n + 3) / 4);
+}
+
+// 压缩一块：自己统计频率、建码表，码长按半字节打包写在块头；
+// 四段各编成一条独立码流，前三条的字节数（4 字节小端）跟在码长后面。返回块的总字节数
+size_t compressBlock(const uchar* src, size_t n, uchar* dst, bool useHeap) {
+    ll freq[SYMBOLS] = {0};
+    histogramKernel(src, n, freq);
+    uchar lengths[SYMBOLS];
+    buildCodeLengths(freq, lengths, useHeap);
+    for (int i = 0; i < SYMBOLS; i += 2) {
+        dst[i / 2] = (uchar)((lengths[i] << 4) | lengths[i + 1]);
+    }
+    Canonical canon;
+    canon.assign(lengths);
+    size_t from[5];
+    splitQuarters(n, from);
+    size_t pos = BLOCK_HEADER_SIZE;
+    for (int k = 0; k < 4; k++) {
+        size_t len = encodeStream(canon, src + from[k], from[k + 1] - from[k], dst + pos);
+        if (k < 3) putLE(dst + BLOCK_TABLE_SIZE + 4 * k, len, 4);
+        pos += len;
+    }
+    return pos;
+}
+
+// 解压一块：dec 是调用方（每个线程一个）复用的解码器
+bool decompressBlock(Decoder& dec, const uchar* src, size_t srcLen, uchar* out, size_t n) {
+    if (srcLen < (size_t)BLOCK_HEADER_SIZE) return false;
+    uchar lengths[SYMBOLS];
+    for (int i = 0; i < SYMBOLS; i += 2) {
+        lengths[i] = src[i / 2] >> 4;
+        lengths[i + 1] = src[i / 2] & 15;
+    }
+    if (!dec.init(lengths)) return false;
+
+    // 定位四条码流
+    const uchar* streamAt[5];
+    streamAt[0] = src + BLOCK_HEADER_SIZE;
+    streamAt[4] = src + srcLen;
+    for (int k = 0; k < 3; k++) {
+        size_t len = (size_t)getLE(src + BLOCK_TABLE_SIZE + 4 * k, 4);
+        if (len > (size_t)(streamAt[4] - streamAt[k])) return false;
+        streamAt[k + 1] = streamAt[k] + len;
+    }
+    size_t from[5];
+    splitQuarters(n, from);
+    BitReader br[4] = {
+        BitReader(streamAt[0], streamAt[1]), BitReader(streamAt[1], streamAt[2]),
+        BitReader(streamAt[2], streamAt[3]), BitReader(streamAt[3], streamAt[4]),
+    };
+    uchar* o[4];
+    uchar* oEnd[4];
+    for (int k = 0; k < 4; k++) {
+        o[k] = out + from[k];
+        oEnd[k] = out + from[k + 1];
+    }
+    return dec.decode4(br, o, oEnd);
+}
+
+// --- 简易线程池 ---
+// 任务就是块号 0 ~ tasks-1：每个线程用原子计数器领下一个块，做完再领，直到领完。
+// 各块耗时差不多，这样的动态分配已经足够均衡。job(worker, task) 中 worker 是线程编号，
+// 方便每个线程使用自己的解码器等状态
+template <class Job>
+void runTasks(int tasks, int threads, Job job) {
+    if (threads > tasks) threads = tasks;
+    if (threads <= 1) {
+        for (int t = 0; t < tasks; t++) job(0, t);
+        return;
+    }
+    std::atomic<int> next(0);
+    auto worker = [&](int id) {
+        int t;
+        while ((t = next.fetch_add(1)) < tasks) job(id, t);
+    };
+    std::thread* pool = new std::thread[threads - 1];
+    for (int i = 1; i < threads; i++) pool[i - 1] = std::thread(worker, i);
+    worker(0);
+    for (int i = 1; i < threads; i++) pool[i - 1].join();
+    delete[] pool;
+}
+
+// --- 压缩 ---
+// 单流格式：整份输入一张码表
+int compressSingle(const uchar* in, size_t n, bool useHeap, int threads) {
+    ll freq[SYMBOLS];
+    histogram(in, n, freq, threads);
+
+    uchar lengths[SYMBOLS];
+    buildCodeLengths(freq, lengths, useHeap);
+    Canonical canon;
+    canon.assign(lengths);
+
+    size_t cap = HEADER_SIZE + streamBound(n);
+    uchar* out = new uchar[cap];
+    memcpy(out, "HUF1", 4);
+    putLE(out + 4, n, 8);
+    memcpy(out + 12, lengths, SYMBOLS);
+    size_t len = encodeStream(canon, in, n, out + HEADER_SIZE);
+
+    fwrite(out, 1, HEADER_SIZE + len, stdout);
+    delete[] out;
+    return 0;
+}
+
+// 分块格式：先让每块写进各自的最坏长度槽位，全部完成后再按顺序挪紧、填写索引
+int compressBlocks(const uchar* in, size_t n, size_t blockSize, bool useHeap, int threads) {
+    int blocks = (int)((n + blockSize - 1) / blockSize);
+    size_t headLen = 4 + 8 + 4 + 4 + 8 * ((size_t)blocks + 1);
+    size_t slot = blockBound(blockSize);
+    uchar* out = new uchar[headLen + slot * blocks];
+    size_t* sizes = new size_t[blocks > 0 ? blocks : 1];
+
+    // 堆建树用的是全局堆，只能单线程
+    if (useHeap) threads = 1;
+    runTasks(blocks, threads, [&](int, int b) {
+        size_t from = (size_t)b * blockSize;
+        size_t len = (n - from < blockSize) ? n - from : blockSize;
+        sizes[b] = compressBlock(in + from, len, out + headLen + slot * b, useHeap);
+    });
+
+    memcpy(out, "HUF2", 4);
+    putLE(out + 4, n, 8);
+    putLE(out + 12, blockSize, 4);
+    putLE(out + 16, (ull)blocks, 4);
+    size_t offset = 0;
+    for (int b = 0; b < blocks; b++) {
+        putLE(out + 20 + 8 * b, offset, 8);
+        memmove(out + headLen + offset, out + headLen + slot * b, sizes[b]);
+        offset += sizes[b];
+    }
+    putLE(out + 20 + 8 * blocks, offset, 8);
+
+    fwrite(out, 1, headLen + offset, stdout);
+    delete[] sizes;
+    delete[] out;
+    return 0;
+}
+
+int compressMode(bool useHeap, int threads, bool single, size_t blockSize) {
+    Input input = openInput();
+    int rc = single ? compressSingle(input.data, input.len, useHeap, threads)
+                    : compressBlocks(input.data, input.len, blockSize, useHeap, threads);
+    closeInput(input);
+    return rc;
+}
+
+// --- 解压 ---
+bool decompressSingle(const uchar* in, size_t n) {
+    if (n < (size_t)HEADER_SIZE) return false;
+    ull origLen = getLE(in + 4, 8);
+    // 原文长度来自文件头，不可信：每个码字至少 1 位，码流最多编码 8 倍字节数的符号，
+    // 超过就一定是坏文件，先拒绝再分配，免得按一个荒唐的长度去申请内存
+    if (origLen > (ull)(n - HEADER_SIZE) * 8) return false;
+    Decoder* dec = new Decoder();
+    uchar* out = new uchar[origLen > 0 ? origLen : 1];
+    bool ok = dec->init(in + 12) && dec->decode(in + HEADER_SIZE, in + n, out, origLen);
+    if (ok) fwrite(out, 1, origLen, stdout);
+    delete[] out;
+    delete dec;
+    return ok;
+}
+
+// onlyBlock >= 0 时只解出这一块（随机访问），其余块的数据完全不碰
+bool decompressBlocks(const uchar* in, size_t n, int threads, int onlyBlock) {
+    if (n < 20) return false;
+    ull origLen = getLE(in + 4, 8);
+    ull blockSize = getLE(in + 12, 4);
+    ull blocks = getLE(in + 16, 4);
+    // 头部字段不可信：块大小不超过压缩端允许的 1 GB；原文长度不超过码流最多能编码的 8 倍字节数
+    // （每个码字至少 1 位），先排除掉，后面按它们分配内存和计算下标才安全
+    if (blockSize == 0 || blockSize > ((ull)1 << 30)) return false;
+    if (origLen > (ull)(n - 20) * 8) return false;
+    if (blocks != (origLen + blockSize - 1) / blockSize) return false;
+    size_t headLen = 4 + 8 + 4 + 4 + 8 * (size_t)(blocks + 1);
+    if (n < headLen) return false;
+    const uchar* index = in + 20;
+    const uchar* data = in + headLen;
+    size_t dataLen = n - headLen;
+    for (ull b = 0; b < blocks; b++) {
+        if (getLE(index + 8 * b, 8) > getLE(index + 8 * (b + 1), 8)) return false;
+    }
+    if (getLE(index + 8 * blocks, 8) > dataLen) return false;
+    if (origLen > (ull)dataLen * 8) return false;
+    if (onlyBlock >= 0 && (ull)onlyBlock >= blocks) return false;
+
+    int first = onlyBlock >= 0 ? onlyBlock : 0;
+    int count = onlyBlock >= 0 ? 1 : (int)blocks;
+    size_t outFrom = (size_t)first * blockSize;
+    size_t outLen = onlyBlock >= 0 ? (origLen - outFrom < blockSize ? origLen - outFrom : blockSize)
+                                   : (size_t)origLen;
+    uchar* out = new uchar[outLen > 0 ? outLen : 1];
+    if (threads > count) threads = count;
+    if (threads < 1) threads = 1;
+    Decoder* decs = new Decoder[threads];
+    std::atomic<bool> ok(true);
+
+    runTasks(count, threads, [&](int worker, int t) {
+        ull b = (ull)(first + t);
+        size_t from = (size_t)getLE(index + 8 * b, 8);
+        size_t to = (size_t)getLE(index + 8 * (b + 1), 8);
+        size_t pos = (size_t)(b * blockSize);
+        size_t len = (origLen - pos < blockSize) ? (size_t)(origLen - pos) : (size_t)blockSize;
+        if (!decompressBlock(decs[worker], data + from, to - from, out + (pos - outFrom), len)) ok = false;
+    });
+
+    if (ok) fwrite(out, 1, outLen, stdout);
+    delete[] decs;
+    delete[] out;
+    return ok;
+}
+
+int decompressMode(int threads, int onlyBlock) {
+    Input input = openInput();
+    const uchar* in = input.data;
+    size_t n = input.len;
+    bool ok;
+    if (n >= 4 && memcmp(in, "HUF2", 4) == 0) {
+        ok = decompressBlocks(in, n, threads, onlyBlock);
+    } else if (n >= 4 && memcmp(in, "HUF1", 4) == 0 && onlyBlock < 0) {
+        ok = decompressSingle(in, n);
+    } else {
+        fprintf(stderr, "huffman: not a compressed stream\n");
+        closeInput(input);
+        return 1;
+    }
+    if (!ok) fprintf(stderr, "huffman: corrupt stream\n");
+    closeInput(input);
+    return ok ? 0 : 1;
+}
+
+// --- 主函数 ---
+int main(int argc, char* argv[]) {
+    bool compress = argc > 1 && strcmp(argv[1], "-c") == 0;
+    bool decompress = argc > 1 && strcmp(argv[1], "-d") == 0;
+    if (!compress && !decompress) return lengthMode();
+
+    bool useHeap = false;
+    bool single = false;
+    int threads = (int)std::thread::hardware_concurrency();
+    size_t blockSize = DEFAULT_BLOCK_SIZE;
+    int onlyBlock = -1;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--heap") == 0) useHeap = true;
+        else if (strcmp(argv[i], "--single") == 0) single = true;
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--block-size") == 0 && i + 1 < argc) blockSize = (size_t)atol(argv[++i]) << 10;
+        else if (strcmp(argv[i], "--block") == 0 && i + 1 < argc) onlyBlock = atoi(argv[++i]);
+    }
+    if (threads < 1) threads = 1;
+    if (blockSize == 0 || blockSize > ((size_t)1 << 30)) blockSize = DEFAULT_BLOCK_SIZE;
+
+    if (compress) return compressMode(useHeap, threads, single, blockSize);
+    return decompressMode(threads, onlyBlock);
+}
@@ -1,173 +1,646 @@
 #include <iostream>
 #include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <new>
+#include <chrono>
+#include <thread>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
-// 全局数组模拟堆
-// N=5000 是题目可能的最大规模，开大一点防止越界
-// 这里的堆是"小顶堆"（Min-Heap），即堆顶元素是最小的
-int heap[10005]; 
-int heapSize = 0; // 记录当前堆中元素的个数
-
-// 手写交换函数
-// 参数使用引用 (int &a)，这样可以直接修改传入变量的内存值，避免数据拷贝，提高效率
-void mySwap(int &a, int &b) {
-    int temp = a;
-    a = b;
-    b = temp;
-}
+// ============================================================
+// D 叉小顶堆 DaryHeap<T, D, Compare>
+// ============================================================
+// 以前是全局数组 heap[10005] 上的二叉堆，上浮/下沉每层都 mySwap 一次。现在：
+//   * D 叉（编译期给定 2/4/8）：树高从 log2(n) 降到 logD(n)，下沉时每层多比较几个孩子，
+//     但这几个孩子在内存里是连续的，通常落在同一条缓存行里
+//   * 存储按需倍增，起始地址按 64 字节对齐，并让每组兄弟节点从 D 的整数倍位置开始
+//     （见 slot() 的说明）：int 的 4 叉/8 叉堆，一组孩子恰好不跨缓存行
+//   * 上浮/下沉“挪空位”而不是交换：待放置的元素拿在手里，沿路把父/子节点挪进空位，
+//     最后只写一次，每层省掉一半的内存写
+//   * 找最小孩子时，int + 小于比较的 4 叉/8 叉堆用 SIMD 一次比完一整组
+// 编译时用 -DHEAP_ARITY=<D> 选择主程序使用的叉数（默认 4）。
+// T 按值拷贝（int、小结构体之类），不调用析构函数。
 
-// 【上浮操作】 (Shift Up)
-// 用于插入新元素后，将其移动到正确位置
-// 逻辑：如果当前节点比它的父节点更小，就交换（维持小顶堆特性），直到不能交换为止
-void shiftUp(int index) {
-    while (index > 1) { // 只要不是根节点(下标1)，就有父节点
-        int parent = index / 2; // 父节点的下标是当前下标除以2
-        
-        // 如果当前节点比父节点小，违反了小顶堆规则，需要交换
-        if (heap[index] < heap[parent]) {
-            mySwap(heap[index], heap[parent]);
-            index = parent; // 指针向上移动，继续检查上一层
-        } else {
-            break; // 如果比父节点大（或相等），说明位置正确，停止上浮
+#ifndef HEAP_ARITY
+#define HEAP_ARITY 4
+#endif
+
+// 默认比较：a < b 时 a 更靠近堆顶
+template <class T>
+struct Less {
+    bool operator()(const T& a, const T& b) const { return a < b; }
+};
+
+// -------------------- 最小孩子查找 --------------------
+// 在 D 个连续孩子 c[0..D) 中找“最小”的那个，返回其偏移；有并列时取最靠前的
+template <class T, int D, class Compare>
+struct MinChild {
+    static int find(const T* c, const Compare& cmp) {
+        int best = 0;
+        for (int i = 1; i < D; ++i) {
+            if (cmp(c[i], c[best])) best = i;
         }
+        return best;
     }
+};
+
+#if defined(__SSE2__)
+// SSE2 没有 32 位有符号 min，用比较 + 与/非 拼出来
+inline __m128i simdMin4(__m128i a, __m128i b) {
+    __m128i gt = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+}
+
+// 把 4 个通道都变成 v 的最小值
+inline __m128i simdBroadcastMin4(__m128i v) {
+    v = simdMin4(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = simdMin4(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return v;
 }
 
-// 【下沉操作】 (Shift Down)
-// 用于删除堆顶或建堆时。将当前节点向下移动，保持堆的有序性
-// 逻辑：找到左右孩子中更小的那个，如果当前节点比它大，就交换
-void shiftDown(int index) {
-    // 只要当前节点有左孩子 (index * 2 <= heapSize)，就继续循环
-    while (index * 2 <= heapSize) {
-        int child = index * 2; // 默认先看左孩子
-        
-        // 如果右孩子存在 (child + 1 <= heapSize) 且 右孩子比左孩子更小
-        // 那么我们就应该跟右孩子比较（因为我们要选最小的浮上来）
-        if (child + 1 <= heapSize && heap[child + 1] < heap[child]) {
-            child++; // child 变成右孩子的下标
-        }
-        
-        // 比较当前节点和较小的那个子节点
-        if (heap[child] < heap[index]) {
-            mySwap(heap[child], heap[index]); // 子节点更小，交换，让小的上来
-            index = child; // 指针向下移动，继续检查下一层
+// int 的 4 叉堆：求出最小值后广播，与原向量比较相等，掩码最低位就是第一个最小孩子
+template <>
+struct MinChild<int, 4, Less<int>> {
+    static int find(const int* c, const Less<int>&) {
+        __m128i v = _mm_loadu_si128((const __m128i*)c);
+        __m128i eq = _mm_cmpeq_epi32(v, simdBroadcastMin4(v));
+        return __builtin_ctz(_mm_movemask_ps(_mm_castsi128_ps(eq)));
+    }
+};
+
+template <>
+struct MinChild<int, 8, Less<int>> {
+    static int find(const int* c, const Less<int>&) {
+#if defined(__AVX2__)
+        __m256i v = _mm256_loadu_si256((const __m256i*)c);
+        __m256i m = _mm256_min_epi32(v, _mm256_permute2x128_si256(v, v, 1));
+        m = _mm256_min_epi32(m, _mm256_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+        m = _mm256_min_epi32(m, _mm256_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+        __m256i eq = _mm256_cmpeq_epi32(v, m);
+        return __builtin_ctz(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+#else
+        __m128i lo = _mm_loadu_si128((const __m128i*)c);
+        __m128i hi = _mm_loadu_si128((const __m128i*)(c + 4));
+        __m128i m = simdBroadcastMin4(simdMin4(lo, hi));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(lo, m))) |
+                   (_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(hi, m))) << 4);
+        return __builtin_ctz(mask);
+#endif
+    }
+};
+#endif
+
+// -------------------- 堆本体 --------------------
+template <class T, int D = 4, class Compare = Less<T>>
+class DaryHeap {
+    static_assert(D == 2 || D == 4 || D == 8, "DaryHeap: D must be 2, 4 or 8");
+
+private:
+    T* data;      // 64 字节对齐的存储
+    int count;    // 当前元素个数
+    int capacity; // 逻辑下标的容量（不含前面的 D-1 个填充槽）
+    Compare cmp;
+
+    // 逻辑下标 i（根为 0，i 的孩子是 D*i+1 .. D*i+D）存放在 data[i + D - 1]。
+    // 这样 i 的第一个孩子落在 D*(i+1)，正好是 D 的整数倍；
+    // 配合 64 字节对齐，每组兄弟都在同一条缓存行里（只要 D*sizeof(T) 不超过 64）
+    T& slot(int i) { return data[i + D - 1]; }
+    const T& slot(int i) const { return data[i + D - 1]; }
+
+    void grow(int need) {
+        int cap = capacity > 0 ? capacity : 16;
+        while (cap < need) cap *= 2;
+        size_t bytes = sizeof(T) * (size_t)(cap + D - 1);
+        T* fresh = (T*)::operator new(bytes, align_val_t(64));
+        memset((void*)fresh, 0, bytes);
+        if (data) {
+            memcpy((void*)fresh, (const void*)data, sizeof(T) * (size_t)(capacity + D - 1));
+            ::operator delete((void*)data, align_val_t(64));
+        }
+        data = fresh;
+        capacity = cap;
+    }
+
+    // 【上浮】空位从 index 出发，父节点比 val 大就把父节点挪下来，空位上移
+    void siftUp(int index, T val) {
+        while (index > 0) {
+            int parent = (index - 1) / D;
+            if (!cmp(val, slot(parent))) break;
+            slot(index) = slot(parent);
+            index = parent;
+        }
+        slot(index) = val;
+    }
+
+    // 【下沉】空位从 index 出发，最小孩子比 val 小就把它挪上来，空位下移
+    void siftDown(int index, T val) {
+        // 孩子满 D 个的最后一个节点，之前的节点都可以整组比较
+        int lastFull = (count - 1 - D >= 0) ? (count - 1 - D) / D : -1;
+        while (true) {
+            int first = D * index + 1;
+            if (first >= count) break;
+            int child;
+            if (index <= lastFull) {
+                child = first + MinChild<T, D, Compare>::find(&slot(first), cmp);
+            } else {
+                child = first;
+                for (int c = first + 1; c < count; ++c) {
+                    if (cmp(slot(c), slot(child))) child = c;
+                }
+            }
+            if (!cmp(slot(child), val)) break;
+            slot(index) = slot(child);
+            index = child;
+        }
+        slot(index) = val;
+    }
+
+    // 【Floyd 下沉】空位从 index 出发，不和 val 比较，一路跟着最小孩子沉到叶子，
+    // 再把 val 放进空位上浮。弹堆顶时 val 是原来的末尾元素，几乎总要沉到底，
+    // 普通下沉每层多出来的那次“孩子 vs val”比较基本都是白做的，
+    // 这样每层少比较一次，而上浮通常一两层就停
+    void bounceDown(int index, T val) {
+        int lastFull = (count - 1 - D >= 0) ? (count - 1 - D) / D : -1;
+        while (true) {
+            int first = D * index + 1;
+            if (first >= count) break;
+            int child;
+            if (index <= lastFull) {
+                child = first + MinChild<T, D, Compare>::find(&slot(first), cmp);
+            } else {
+                child = first;
+                for (int c = first + 1; c < count; ++c) {
+                    if (cmp(slot(c), slot(child))) child = c;
+                }
+            }
+            slot(index) = slot(child);
+            index = child;
+        }
+        siftUp(index, val);
+    }
+
+public:
+    DaryHeap() : data(nullptr), count(0), capacity(0) { grow(16); }
+
+    ~DaryHeap() { ::operator delete((void*)data, align_val_t(64)); }
+
+    DaryHeap(const DaryHeap&) = delete;
+    DaryHeap& operator=(const DaryHeap&) = delete;
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    void reserve(int n) {
+        if (n > capacity) grow(n);
+    }
+
+    // 【插入】放到末尾的空位上，再上浮
+    void push(const T& val) {
+        if (count == capacity) grow(count + 1);
+        count++;
+        siftUp(count - 1, val);
+    }
+
+    // 【批量插入】先把 k 个元素全部追加到末尾，再自底向上只修复受影响的祖先：
+    // 新元素的父节点在一段连续区间里，对这段区间从后往前下沉（与 Floyd 建堆相同），
+    // 然后区间变成它们的父节点区间，逐层向上直到根。
+    // 靠下的宽区间合计 O(k)；但区间收窄到一两个节点后，往上每一层仍要从该层一路下沉到底，
+    // 这部分是 O(logD^2 n)。所以总代价 O(k + logD^2 n)：k 比树高还小时反而不如逐个 push，
+    // 这时直接退回逐个 push（每个最坏 O(logD n)）
+    void pushBatch(const T* vals, int k) {
+        if (k <= 0) return;
+        int levels = 0; // 插入后的树高 ≈ logD(count + k)
+        for (long long w = 1; w < (long long)count + k; w = w * D + 1) levels++;
+        if (k <= levels) {
+            for (int i = 0; i < k; ++i) push(vals[i]);
+            return;
+        }
+        if (count + k > capacity) grow(count + k);
+        int old = count;
+        for (int i = 0; i < k; ++i) {
+            slot(old + i) = vals[i];
+        }
+        count += k;
+        if (count == 1) return;
+        int lo = (old > 0 ? old - 1 : 0) / D;
+        int hi = (count - 2) / D;
+        while (true) {
+            for (int i = hi; i >= lo; --i) {
+                siftDown(i, slot(i));
+            }
+            if (lo == 0) break;
+            lo = (lo - 1) / D;
+            hi = (hi - 1) / D;
+        }
+    }
+
+    // 【弹出堆顶】拿出最后一个元素，从根的空位开始 Floyd 下沉
+    // 堆变空时不改动根位置，top() 仍能读到刚弹出的值（与旧版全局数组的行为一致）
+    void pop() {
+        if (count < 1) return;
+        T last = slot(count - 1);
+        count--;
+        if (count > 0) bounceDown(0, last);
+    }
+
+    // 【堆排序】依次弹出全部元素，按从小到大写入 out，结束后堆为空
+    void drainSorted(T* out) {
+        int total = count;
+        for (int i = 0; i < total; ++i) {
+            out[i] = slot(0);
+            pop();
+        }
+    }
+
+    // 【获取堆顶】空堆时返回根位置上残留的值
+    const T& top() const { return slot(0); }
+
+    // 【建堆操作】 (Floyd建堆算法)，O(n)
+    // 从最后一个"非叶子节点"开始，依次向前执行下沉操作
+    void build(const T* nums, int n) {
+        if (n > capacity) grow(n);
+        for (int i = 0; i < n; i++) {
+            slot(i) = nums[i];
+        }
+        count = n;
+        for (int i = (n - 2) / D; i >= 0 && n > 1; i--) {
+            siftDown(i, slot(i));
+        }
+    }
+};
+
+// -------------------- 索引堆 --------------------
+// IndexedHeap<K, D, Compare>：堆中的每个元素带一个句柄 id（0 ~ maxId-1），
+// pos[id] 记录它当前在堆里的位置，于是可以按句柄 O(logD n) 地改键、删除。
+// 典型用途是 Prim / Dijkstra：每个顶点在堆中至多一份，
+// 距离变小就 decreaseKey，不必再压入重复条目，堆的大小以顶点数为上限。
+// 堆元素把键和句柄放在一起存，比较时不用再按 id 去别处取键。
+template <class K, int D = 4, class Compare = Less<K>>
+class IndexedHeap {
+    static_assert(D >= 2, "IndexedHeap: D must be at least 2");
+
+private:
+    struct Entry {
+        K key;
+        int id;
+    };
+
+    Entry* heap;  // 逻辑下标 0 为堆顶，i 的孩子是 D*i+1 .. D*i+D
+    int* pos;     // pos[id]：句柄在 heap 中的下标，-1 表示不在堆中
+    int count;
+    int maxId;
+    Compare cmp;
+
+    void place(int index, const Entry& e) {
+        heap[index] = e;
+        pos[e.id] = index;
+    }
+
+    // 挪空位的上浮/下沉，与 DaryHeap 相同，只是每次挪动都要同步 pos[]
+    void siftUp(int index, Entry e) {
+        while (index > 0) {
+            int parent = (index - 1) / D;
+            if (!cmp(e.key, heap[parent].key)) break;
+            place(index, heap[parent]);
+            index = parent;
+        }
+        place(index, e);
+    }
+
+    void siftDown(int index, Entry e) {
+        while (true) {
+            int first = D * index + 1;
+            if (first >= count) break;
+            int end = first + D < count ? first + D : count;
+            int child = first;
+            for (int c = first + 1; c < end; ++c) {
+                if (cmp(heap[c].key, heap[child].key)) child = c;
+            }
+            if (!cmp(heap[child].key, e.key)) break;
+            place(index, heap[child]);
+            index = child;
+        }
+        place(index, e);
+    }
+
+public:
+    explicit IndexedHeap(int handles) : count(0), maxId(handles > 0 ? handles : 1) {
+        heap = new Entry[maxId];
+        pos = new int[maxId];
+        for (int i = 0; i < maxId; ++i) pos[i] = -1;
+    }
+
+    ~IndexedHeap() {
+        delete[] heap;
+        delete[] pos;
+    }
+
+    IndexedHeap(const IndexedHeap&) = delete;
+    IndexedHeap& operator=(const IndexedHeap&) = delete;
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool contains(int id) const { return pos[id] != -1; }
+    const K& keyOf(int id) const { return heap[pos[id]].key; }
+
+    int topId() const { return heap[0].id; }
+    const K& topKey() const { return heap[0].key; }
+
+    // 插入一个不在堆中的句柄；句柄已在堆中时返回 false
+    bool push(int id, const K& key) {
+        if (pos[id] != -1) return false;
+        count++;
+        siftUp(count - 1, Entry{key, id});
+        return true;
+    }
+
+    // 把句柄的键改小；新键并不更小（或句柄不在堆中）时什么也不做，返回 false
+    bool decreaseKey(int id, const K& key) {
+        int index = pos[id];
+        if (index == -1 || !cmp(key, heap[index].key)) return false;
+        siftUp(index, Entry{key, id});
+        return true;
+    }
+
+    // 按句柄删除：用最后一个元素填空位，它可能比原来的父节点小（上浮）或比孩子大（下沉）
+    bool erase(int id) {
+        int index = pos[id];
+        if (index == -1) return false;
+        pos[id] = -1;
+        Entry last = heap[--count];
+        if (index == count) return true; // 删的正好是最后一个
+        if (index > 0 && cmp(last.key, heap[(index - 1) / D].key)) {
+            siftUp(index, last);
         } else {
-            break; // 如果当前节点比子节点都小，说明位置正确，停止下沉
+            siftDown(index, last);
         }
+        return true;
     }
-}
 
-// 【插入操作】
-// 逻辑：先把新元素放到数组末尾，然后执行上浮操作
-void insert(int val) {
-    heapSize++;          // 堆的大小+1
-    heap[heapSize] = val; // 放入数组末尾
-    shiftUp(heapSize);    // 让新元素上浮到正确位置
+    // 弹出堆顶，返回它的句柄
+    int pop() {
+        int id = heap[0].id;
+        erase(id);
+        return id;
+    }
+};
+
+// -------------------- 性能测试 --------------------
+// --bench N：分别用 2/4/8 叉堆做 N 次随机 push，再交替 push/pop N 次，最后全部 pop，
+// 再测一次索引堆的 decreaseKey，各自的耗时打印到 stderr
+template <int D>
+void benchArity(int n) {
+    DaryHeap<int, D> h;
+    unsigned int seed = 12345;
+    auto t0 = chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        h.push((int)(seed >> 1));
+    }
+    for (int i = 0; i < n; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        h.push((int)(seed >> 1));
+        h.pop();
+    }
+    long long check = 0;
+    while (!h.empty()) {
+        check += h.top();
+        h.pop();
+    }
+    auto t1 = chrono::steady_clock::now();
+    double ms = chrono::duration<double, milli>(t1 - t0).count();
+    fprintf(stderr, "D=%d  n=%d  %.1f ms  (checksum %lld)\n", D, n, ms, check);
 }
 
-// 【弹出堆顶】
-// 逻辑：将堆顶元素用数组末尾元素覆盖，然后删除末尾，最后让新的堆顶下沉
-void pop() {
-    if (heapSize < 1) return; // 堆为空，直接返回
-    
-    heap[1] = heap[heapSize]; // 用最后一个元素覆盖堆顶（根节点）
-    heapSize--;               // 堆大小减1（相当于删除了原来的堆顶）
-    
-    if (heapSize > 0) {
-        shiftDown(1); // 让新的根节点下沉到正确位置
+// 索引堆：n 个句柄全部入堆，再随机做 n 次 decreaseKey，最后全部弹出
+void benchIndexed(int n) {
+    IndexedHeap<int, HEAP_ARITY> h(n);
+    unsigned int seed = 777;
+    auto t0 = chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        h.push(i, (int)(seed >> 1));
+    }
+    for (int i = 0; i < n; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int id = (int)((seed >> 8) % (unsigned int)n);
+        if (h.contains(id)) h.decreaseKey(id, h.keyOf(id) - (int)(seed >> 20));
     }
+    long long check = 0;
+    while (!h.empty()) {
+        check += h.topKey();
+        h.pop();
+    }
+    auto t1 = chrono::steady_clock::now();
+    double ms = chrono::duration<double, milli>(t1 - t0).count();
+    fprintf(stderr, "indexed D=%d  n=%d  %.1f ms  (checksum %lld)\n", HEAP_ARITY, n, ms, check);
 }
 
-// 【获取堆顶】
-// 小顶堆的堆顶就是整个堆的最小值
-int top() {
-    return heap[1];
+// 批量插入：同样 n 个随机数，逐个 push 与按 1024 个一批 pushBatch 各做一遍
+void benchBatch(int n) {
+    const int BATCH = 1024;
+    int* vals = new int[BATCH];
+    for (int mode = 0; mode < 2; ++mode) {
+        DaryHeap<int, HEAP_ARITY> h;
+        unsigned int seed = 4242;
+        auto t0 = chrono::steady_clock::now();
+        for (int done = 0; done < n; done += BATCH) {
+            int k = n - done < BATCH ? n - done : BATCH;
+            for (int i = 0; i < k; ++i) {
+                seed = seed * 1103515245u + 12345u;
+                vals[i] = (int)(seed >> 1);
+            }
+            if (mode == 0) {
+                for (int i = 0; i < k; ++i) h.push(vals[i]);
+            } else {
+                h.pushBatch(vals, k);
+            }
+        }
+        auto t1 = chrono::steady_clock::now();
+        double ms = chrono::duration<double, milli>(t1 - t0).count();
+        fprintf(stderr, "%s D=%d  n=%d  %.1f ms  (top %d)\n", mode == 0 ? "push     " : "pushBatch",
+                HEAP_ARITY, n, ms, h.top());
+    }
+    delete[] vals;
 }
 
-// 【建堆操作】 (Floyd建堆算法)
-// 时间复杂度是 O(n)，比一个个插入 O(nlogn) 更快
-void build(int nums[], int n) {
-    heapSize = 0;
-    // 1. 先将数据原样填入 heap 数组（从下标1开始填）
-    for (int i = 0; i < n; i++) {
-        heap[i + 1] = nums[i];
+// -------------------- 多线程堆排序 --------------------
+// 数组切成 threads 段，每个线程用自己的堆排好一段，
+// 最后用一个小堆对各段做多路归并（堆里放“值 + 段号”）。
+// 结果与单线程完全相同（整数排序结果唯一）。
+const int PARALLEL_SORT_MIN = 1 << 16; // 少于这么多个数时线程开销不划算
+
+struct RunHead {
+    int val;
+    int run;
+    bool operator<(const RunHead& other) const { return val < other.val; }
+};
+
+void parallelHeapSort(const int* a, int n, int* out, int threads) {
+    int* runs = new int[n];
+    int* start = new int[threads + 1];
+    for (int t = 0; t <= threads; ++t) {
+        start[t] = (int)((long long)n * t / threads);
+    }
+    auto sortRun = [&](int t) {
+        DaryHeap<int, HEAP_ARITY> h;
+        h.build(a + start[t], start[t + 1] - start[t]);
+        h.drainSorted(runs + start[t]);
+    };
+    thread* pool = new thread[threads - 1];
+    for (int t = 1; t < threads; ++t) pool[t - 1] = thread(sortRun, t);
+    sortRun(0);
+    for (int t = 1; t < threads; ++t) pool[t - 1].join();
+    delete[] pool;
+
+    int* cursor = new int[threads];
+    DaryHeap<RunHead, HEAP_ARITY> merge;
+    for (int t = 0; t < threads; ++t) {
+        cursor[t] = start[t];
+        if (cursor[t] < start[t + 1]) merge.push(RunHead{runs[cursor[t]], t});
     }
-    heapSize = n;
-    
-    // 2. 从最后一个"非叶子节点"开始，依次向前执行下沉操作
-    // heapSize / 2 是最后一个非叶子节点的下标
-    for (int i = heapSize / 2; i >= 1; i--) {
-        shiftDown(i);
+    for (int i = 0; i < n; ++i) {
+        RunHead h = merge.top();
+        merge.pop();
+        out[i] = h.val;
+        if (++cursor[h.run] < start[h.run + 1]) merge.push(RunHead{runs[cursor[h.run]], h.run});
     }
+    delete[] cursor;
+    delete[] start;
+    delete[] runs;
 }
 
-int main() {
+// 命令行参数（可省略）：
+//   --threads N  操作 3 的排序线程数，默认取 CPU 核数
+//   --bench N    性能测试
+int main(int argc, char* argv[]) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], "--bench") == 0) {
+            int n = atoi(argv[i + 1]);
+            benchArity<2>(n);
+            benchArity<4>(n);
+            benchArity<8>(n);
+            benchIndexed(n);
+            benchBatch(n);
+            return 0;
+        }
+    }
+    int threads = (int)thread::hardware_concurrency();
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], "--threads") == 0) threads = atoi(argv[i + 1]);
+    }
+    if (threads < 1) threads = 1;
+
     // IO 加速：取消 C++ iostream 和 C stdio 的同步，加快 cin/cout 速度
     // 这不违反"不使用 STL 算法"的规则，只是加速输入输出
     ios::sync_with_stdio(false);
     cin.tie(NULL);
 
+    // 这里的堆是"小顶堆"（Min-Heap），即堆顶元素是最小的
+    DaryHeap<int, HEAP_ARITY> heap;
+
     int n;
     // 读取初始元素个数，如果读取失败直接退出
     if (!(cin >> n)) return 0;
 
-    // 临时数组存储初始数据
-    int initialNums[5005];
+    // 临时数组存储初始数据（按需分配，不再有固定上限；操作 3 也复用它）
+    int bufCap = n > 16 ? n : 16;
+    int* nums = new int[bufCap];
+    int* sorted = nullptr;
     for (int i = 0; i < n; i++) {
-        cin >> initialNums[i];
+        cin >> nums[i];
     }
 
     // 1. 初始建堆
-    build(initialNums, n);
+    heap.build(nums, n);
     // 输出建堆后的最小值（堆顶）
-    cout << top() << endl;
+    cout << heap.top() << endl;
+
+    // 连续的插入先攒在 pending 里，遇到删除时再一次 pushBatch 进堆。
+    // 插入后的堆顶就是 min(原堆顶, 新数)，不必真的插进去就能输出。
+    // 堆变空后 top() 读到的是最后弹出的那个值，与堆内布局无关，所以批量插入不改变任何输出
+    int pendingCap = 16, pendingCnt = 0;
+    int* pending = new int[pendingCap];
+    int pendingMin = 0;
 
     int m;
     cin >> m; // 读取操作次数
     while (m--) {
         int op;
         cin >> op;
-        
-        if (op == 1) { 
+
+        if (op == 1) {
             // 操作 1: 插入一个新数
             int num;
             cin >> num;
-            insert(num);
-            cout << top() << endl; // 输出当前的最小值
-        } 
+            if (pendingCnt == pendingCap) {
+                int* bigger = new int[pendingCap * 2];
+                memcpy(bigger, pending, sizeof(int) * pendingCnt);
+                delete[] pending;
+                pending = bigger;
+                pendingCap *= 2;
+            }
+            pending[pendingCnt++] = num;
+            if (pendingCnt == 1) pendingMin = heap.empty() ? num : heap.top();
+            if (num < pendingMin) pendingMin = num;
+            cout << pendingMin << endl; // 输出当前的最小值
+        }
         else if (op == 2) {
             // 操作 2: 删除当前最小值（堆顶）
-            pop();
-            cout << top() << endl; // 输出删除后的新最小值
-        } 
+            heap.pushBatch(pending, pendingCnt);
+            pendingCnt = 0;
+            heap.pop();
+            cout << heap.top() << endl; // 输出删除后的新最小值
+        }
         else if (op == 3) {
             // 操作 3: 给定一组新数据，要求排序输出
-            // 注意：这个操作利用了我们现有的堆逻辑，通过覆盖全局 heap 来实现
+            // 注意：这个操作利用了我们现有的堆逻辑，通过覆盖 heap 来实现
             int sortCount;
             cin >> sortCount;
-            
-            // 读取待排序数组
-            int tempNums[1005];
+            // 堆马上会被覆盖，但 sortCount 为 0 时根位置残留的旧堆顶还会被输出，所以照样先放进去
+            heap.pushBatch(pending, pendingCnt);
+            pendingCnt = 0;
+
+            // 读取待排序数组（缓冲区不够就扩大）
+            if (sortCount > bufCap) {
+                delete[] nums;
+                delete[] sorted;
+                sorted = nullptr;
+                bufCap = sortCount;
+                nums = new int[bufCap];
+            }
+            if (sorted == nullptr) sorted = new int[bufCap];
             for(int i = 0; i < sortCount; i++){
-                cin >> tempNums[i];
+                cin >> nums[i];
+            }
+
+            if (threads > 1 && sortCount >= PARALLEL_SORT_MIN) {
+                // 大批量：多线程分段排序 + 归并。
+                // 随后让 heap 与单线程路径的状态一致：清空，且根位置残留最大值
+                parallelHeapSort(nums, sortCount, sorted, threads);
+                heap.build(sorted + sortCount - 1, 1);
+                heap.pop();
+            } else {
+                // 利用 build 函数将这组新数据建成一个小顶堆
+                // 这会覆盖掉之前 heap 里的数据（根据题目逻辑，这可能是独立的或最后的操作）
+                heap.build(nums, sortCount);
+                // 【堆排序逻辑】不断弹出堆顶（最小值），直到堆为空
+                heap.drainSorted(sorted);
             }
-            
-            // 利用 build 函数将这组新数据建成一个小顶堆
-            // 这会覆盖掉之前 heap 里的数据（根据题目逻辑，这可能是独立的或最后的操作）
-            build(tempNums, sortCount);
-            
-            bool first = true;
-            // 【堆排序逻辑】
-            // 不断弹出堆顶（最小值），直到堆为空
-            while(heapSize > 0) {
-                if(!first) cout << " "; // 控制空格格式，第一个数前没空格
-                cout << top(); // 输出最小值
-                pop();         // 弹出它，让剩下的数重新排好
-                first = false;
+
+            for (int i = 0; i < sortCount; i++) {
+                if (i > 0) cout << " "; // 控制空格格式，第一个数前没空格
+                cout << sorted[i];
             }
             cout << endl; // 换行
         }
     }
+    delete[] nums;
+    delete[] sorted;
+    delete[] pending;
     return 0;
-}
\ No newline at end of file
+}
@@ -3,22 +3,35 @@
 
 using namespace std;
 
-// 定义最大节点数
-const int MAXN = 100005;
-
 // === 1. 手动实现邻接链表 ===
 struct Edge {
     int to;
     Edge* next;
 };
 
+// 以下数组都按点数 n 在 init_graph 中一次开好，点数到 10^7 也不受固定上限限制
 // head[u] 存储指向 u 的第一个邻居的指针
-Edge* head[MAXN];
-bool visited[MAXN]; // 访问标记数组
-int dist[MAXN];     // 距离数组
+Edge** head;
+bool* visited; // 访问标记数组
+int* dist;     // 距离数组
+int* adj_start; // CSR 每段起点，见 build_csr
+int* seq_dfs;  // DFS 序列
+int* seq_bfs;  // BFS 序列
+int* stk;      // DFS 显式栈：每层的点
+int* stk_pos;  // DFS 显式栈：每层下一个要看的邻居在 adj 中的下标
+int* que;      // BFS 队列
 
 // 初始化图
 void init_graph(int n) {
+    head = new Edge*[n + 2];
+    visited = new bool[n + 2];
+    dist = new int[n + 2];
+    adj_start = new int[n + 2];
+    seq_dfs = new int[n + 1];
+    seq_bfs = new int[n + 1];
+    stk = new int[n + 1];
+    stk_pos = new int[n + 1];
+    que = new int[n + 1];
     for (int i = 1; i <= n; i++) {
         head[i] = nullptr;
     }
@@ -83,65 +96,81 @@ void quick_sort(int arr[], int left, int right) {
     quick_sort(arr, i, right);
 }
 
-// === 辅助函数：获取某点的所有邻居并排序 ===
-// 返回邻居数量，结果存入 neighbors 数组
-int get_sorted_neighbors(int u, int neighbors[]) {
-    int count = 0;
-    Edge* curr = head[u];
-    while (curr != nullptr) {
-        neighbors[count++] = curr->to;
-        curr = curr->next;
+// === 3. 压缩稀疏行 (CSR) ===
+// 边的增删全部结束后图就不再变化，把邻接链表一次性"冻结"成 CSR：
+// u 的邻居连续存放在 adj[adj_start[u] .. adj_start[u + 1] - 1]，并且已经升序排好。
+// 遍历时直接扫这一段，不必每访问一个点就重新数度数、开数组、排序。
+int* adj = nullptr;
+
+void build_csr(int n) {
+    // 1. 统计度数：先记在 adj_start[u + 1] 上
+    for (int i = 0; i <= n + 1; i++) adj_start[i] = 0;
+    for (int u = 1; u <= n; u++) {
+        for (Edge* e = head[u]; e; e = e->next) adj_start[u + 1]++;
     }
-    if (count > 0) {
-        quick_sort(neighbors, 0, count - 1);
+    // 2. 前缀和：adj_start[u] 变成 u 那一段的起点
+    for (int u = 1; u <= n; u++) adj_start[u + 1] += adj_start[u];
+    // 3. 按起点把邻居散列进去（dist 暂时借来当每段的写指针）
+    adj = new int[adj_start[n + 1] > 0 ? adj_start[n + 1] : 1];
+    for (int u = 1; u <= n; u++) {
+        dist[u] = adj_start[u];
+        for (Edge* e = head[u]; e; e = e->next) adj[dist[u]++] = e->to;
+    }
+    // 4. 每段只排一次序，保证按编号从小到大访问邻居
+    for (int u = 1; u <= n; u++) {
+        if (adj_start[u + 1] - adj_start[u] > 1) {
+            quick_sort(adj, adj_start[u], adj_start[u + 1] - 1);
+        }
     }
-    return count;
 }
 
-// === 3. 算法实现 ===
+// === 4. 算法实现 ===
 
 // 全局变量用于存储遍历结果
-int seq_dfs[MAXN], cnt_dfs = 0;
-int seq_bfs[MAXN], cnt_bfs = 0;
+int cnt_dfs = 0;
+int cnt_bfs = 0;
 
 // 清空访问标记
 void reset_visited(int n) {
     for (int i = 0; i <= n; i++) visited[i] = false;
 }
 
-// DFS (递归版)
-void dfs(int u) {
-    visited[u] = true;
-    seq_dfs[cnt_dfs++] = u;
-
-    // 获取并排序邻居，保证字典序最小
-    int neighbors[MAXN]; // 注意：如果在深层递归中，局部大数组可能爆栈。但一般OJ栈大小够用。
-                         // 如果担心爆栈，可以用动态分配或全局辅助数组(需小心覆盖)。
-                         // 考虑到邻居数通常不多，且总边数有限，这里简化处理。
-    // 为了安全，更严谨的做法是动态开辟：
-    int deg = 0;
-    for(Edge* e = head[u]; e; e=e->next) deg++;
-    int* nbrs = new int[deg];
-    
-    int idx = 0;
-    for(Edge* e = head[u]; e; e=e->next) nbrs[idx++] = e->to;
-    
-    quick_sort(nbrs, 0, deg - 1);
-
-    for (int i = 0; i < deg; i++) {
-        int v = nbrs[i];
-        if (!visited[v]) {
-            dfs(v);
+// DFS (显式栈版)
+// 递归版每深入一层就占一个栈帧，链状图上深度可达 n，点数一大就爆栈。
+// 这里自己维护栈：stk[k] 是第 k 层的点，stk_pos[k] 记着它的邻居扫到了哪里，
+// 每次从栈顶接着找下一个未访问的邻居，找到就压栈，扫完就弹栈，访问顺序与递归版完全一致
+void dfs(int s) {
+    int top = 0;
+    visited[s] = true;
+    seq_dfs[cnt_dfs++] = s;
+    stk[top] = s;
+    stk_pos[top] = adj_start[s];
+    top++;
+
+    while (top > 0) {
+        int u = stk[top - 1];
+        int i = stk_pos[top - 1];
+        // 邻居在 CSR 里已经升序排好，保证字典序最小
+        while (i < adj_start[u + 1] && visited[adj[i]]) i++;
+        if (i == adj_start[u + 1]) {
+            top--; // u 的邻居都访问过了，回溯
+            continue;
         }
+        int v = adj[i];
+        stk_pos[top - 1] = i + 1;
+        visited[v] = true;
+        seq_dfs[cnt_dfs++] = v;
+        stk[top] = v;
+        stk_pos[top] = adj_start[v];
+        top++;
     }
-    delete[] nbrs;
 }
 
 // BFS (手写队列)
 // 参数 t: 起点, s: 目标点(用于计算距离, 如果不需要设为-1)
 // 返回 s 到 t 的距离
 int bfs(int start_node, int target_node, int n) {
-    int q[MAXN];
+    int* q = que;
     int front = 0, rear = 0;
     
     // 初始化距离
@@ -156,38 +185,35 @@ int bfs(int start_node, int target_node, int n) {
         int u = q[front++];
         seq_bfs[cnt_bfs++] = u;
 
-        // 获取并排序邻居
-        int deg = 0;
-        for(Edge* e = head[u]; e; e=e->next) deg++;
-        int* nbrs = new int[deg];
-        int idx = 0;
-        for(Edge* e = head[u]; e; e=e->next) nbrs[idx++] = e->to;
-        quick_sort(nbrs, 0, deg - 1);
-
-        for (int i = 0; i < deg; i++) {
-            int v = nbrs[i];
+        // 按升序扫 u 的邻居段
+        for (int i = adj_start[u]; i < adj_start[u + 1]; i++) {
+            int v = adj[i];
             if (!visited[v]) {
                 visited[v] = true;
                 dist[v] = dist[u] + 1;
                 q[rear++] = v;
             }
         }
-        delete[] nbrs;
     }
     
     if (target_node != -1) return dist[target_node];
     return -1;
 }
 
-// 简单的DFS用于标记连通分量 (不记录序列，仅用于标记)
+// 标记 u 所在的连通分量 (不记录序列，仅用于标记)
+// 只关心能到达哪些点、不关心顺序，所以压栈时就打标记，每个点最多进栈一次，栈深不超过 n
 void mark_component(int u) {
+    int top = 0;
     visited[u] = true;
-    Edge* curr = head[u];
-    while (curr != nullptr) {
-        if (!visited[curr->to]) {
-            mark_component(curr->to);
+    stk[top++] = u;
+    while (top > 0) {
+        int x = stk[--top];
+        for (int i = adj_start[x]; i < adj_start[x + 1]; i++) {
+            if (!visited[adj[i]]) {
+                visited[adj[i]] = true;
+                stk[top++] = adj[i];
+            }
         }
-        curr = curr->next;
     }
 }
 
@@ -212,10 +238,13 @@ int main() {
         }
     }
 
+    // 图已定型，转成 CSR 供后面的遍历使用
+    build_csr(n);
+
     // === 输出 1 & 2: 连通分量数量及每个分量最小点 ===
     reset_visited(n);
     int component_count = 0;
-    int min_nodes[MAXN];
+    int* min_nodes = new int[n + 1];
     int min_nodes_cnt = 0;
 
     for (int i = 1; i <= n; i++) {
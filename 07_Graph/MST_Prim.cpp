@@ -1,4 +1,8 @@
 #include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
 
 // 定义常量
 const int MAXN = 200005; // 最大点数
@@ -31,70 +35,305 @@ void add_edge(int u, int v, int w) {
 }
 
 // ----------------------
-// 2. 手动实现最小堆 (Priority Queue)
+// 2. 优先队列引擎 (统一接口)
 // ----------------------
+// 每个顶点在队列中至多出现一次，三种实现提供相同的接口：
+//   reset(n)         清空，顶点编号 1..n
+//   contains(u)      u 是否在队列中
+//   push(u, d)       插入不在队列中的 u，键为 d
+//   decrease(u, d)   把队列中 u 的键改小为 d
+//   pop()            弹出键最小的顶点（返回 {u, d}）
+//   empty()
+// prim() / dijkstra() 是模板，换引擎不用改算法代码。
+// 编译时用 -DPRIM_HEAP=<n> 选择主程序用的引擎：0 = 二叉索引堆（默认），1 = 配对堆。
+// 基数堆只适用于“弹出的键单调不减”的负载（Dijkstra、事件调度），
+// Prim 的键是各条边的权重，先弹出大的、后压入小的很常见，不满足这一前提，所以不提供给 prim()。
+
+#define PRIM_HEAP_BINARY 0
+#define PRIM_HEAP_PAIRING 1
+
+#ifndef PRIM_HEAP
+#define PRIM_HEAP PRIM_HEAP_BINARY
+#endif
+
 struct HeapNode {
     int u;  // 节点编号
     int d;  // 距离 (key)
-    
+
     // 重载比较，用于逻辑判断
     bool operator<(const HeapNode& other) const {
         return d < other.d;
     }
 };
 
-HeapNode heap[MAXM]; // 堆的大小可能达到边数级别
-int heap_size = 0;
-
-// 上浮操作
-void heap_push(int u, int d) {
-    heap_size++;
-    heap[heap_size] = {u, d};
-    int curr = heap_size;
-    while (curr > 1) {
-        int parent = curr >> 1; // 除以2
-        // 位运算效率更高
-        if (heap[curr].d < heap[parent].d) { // 最小堆：子小于父则交换
-            // 手动交换
-            HeapNode temp = heap[curr];
-            heap[curr] = heap[parent];
-            heap[parent] = temp;
-            curr = parent;
-        } else {
-            break;
+// ---- 2.1 二叉索引堆 ----
+// 以前的堆没有“按节点修改”的能力，dis[v] 变小时只能再压一个 {v, w} 进去，
+// 旧的那份留在堆里成为过期条目，弹出后靠 vis[] 跳过，堆的大小因此要按边数开。
+// 现在 pos[u] 记录 u 在 heap[] 中的下标：
+//   decrease(u, d)  把 u 的键改小后原地上浮，O(log n)
+//   erase(u)        从堆中删除 u，O(log n)
+// 堆的大小不超过点数，弹出的永远是有效条目。
+struct BinaryHeapPQ {
+    HeapNode heap[MAXN]; // 每个点至多一份，按点数开即可
+    int pos[MAXN];       // pos[u]：u 在 heap[] 中的下标，0 表示不在堆中
+    int size = 0;
+
+    // 把 x 放到 curr 位置上，并同步位置表
+    void place(int curr, const HeapNode& x) {
+        heap[curr] = x;
+        pos[x.u] = curr;
+    }
+
+    // 上浮：空位从 curr 出发，父节点比 x 大就挪下来
+    void sift_up(int curr, HeapNode x) {
+        while (curr > 1) {
+            int parent = curr >> 1; // 除以2
+            // 位运算效率更高
+            if (x.d < heap[parent].d) { // 最小堆：子小于父则父节点下移
+                place(curr, heap[parent]);
+                curr = parent;
+            } else {
+                break;
+            }
         }
+        place(curr, x);
     }
-}
 
-// 下沉操作
-HeapNode heap_pop() {
-    HeapNode res = heap[1]; // 堆顶是最小值
-    heap[1] = heap[heap_size];
-    heap_size--;
-    
-    int curr = 1;
-    while ((curr << 1) <= heap_size) {
-        int child = curr << 1; // 左孩子
-        // 如果右孩子存在且比左孩子更小，选择右孩子
-        if (child < heap_size && heap[child + 1].d < heap[child].d) {
-            child++;
+    // 下沉：空位从 curr 出发，较小的孩子比 x 小就挪上来
+    void sift_down(int curr, HeapNode x) {
+        while ((curr << 1) <= size) {
+            int child = curr << 1; // 左孩子
+            // 如果右孩子存在且比左孩子更小，选择右孩子
+            if (child < size && heap[child + 1].d < heap[child].d) {
+                child++;
+            }
+            // 如果孩子比 x 小，孩子上移
+            if (heap[child].d < x.d) {
+                place(curr, heap[child]);
+                curr = child;
+            } else {
+                break;
+            }
         }
-        // 如果孩子比当前节点小，交换
-        if (heap[child].d < heap[curr].d) {
-            HeapNode temp = heap[curr];
-            heap[curr] = heap[child];
-            heap[child] = temp;
-            curr = child;
+        place(curr, x);
+    }
+
+    void reset(int n) {
+        for (int i = 1; i <= n; ++i) pos[i] = 0;
+        size = 0;
+    }
+
+    bool contains(int u) const { return pos[u] != 0; }
+    bool empty() const { return size == 0; }
+
+    void push(int u, int d) {
+        size++;
+        sift_up(size, {u, d});
+    }
+
+    void decrease(int u, int d) {
+        sift_up(pos[u], {u, d});
+    }
+
+    // 删除 u：用最后一个元素填进它的位置，再视大小上浮或下沉
+    void erase(int u) {
+        int curr = pos[u];
+        pos[u] = 0;
+        HeapNode last = heap[size];
+        size--;
+        if (curr > size) return; // 删的正好是最后一个
+        if (curr > 1 && last.d < heap[curr >> 1].d) {
+            sift_up(curr, last);
         } else {
-            break;
+            sift_down(curr, last);
         }
     }
-    return res;
-}
 
-bool heap_empty() {
-    return heap_size == 0;
-}
+    HeapNode pop() {
+        HeapNode res = heap[1]; // 堆顶是最小值
+        erase(res.u);
+        return res;
+    }
+};
+
+// ---- 2.2 配对堆 ----
+// 多叉树，孩子用“左孩子-右兄弟”链起来。
+//   push / decrease：O(1)，新节点（或从原位置剪下来的子树）直接和根合并
+//   pop：摊还 O(log n)，根的孩子两两合并（从左到右），再从右到左依次并成一棵
+// decrease-key 多的负载（稠密图上的 Prim）里比二叉堆少很多次上浮。
+// prv[u]：u 是最左孩子时指向父亲，否则指向左兄弟；用它 O(1) 把 u 从原位置剪下。
+struct PairingHeapPQ {
+    int key[MAXN];
+    int child[MAXN]; // 最左孩子，0 表示没有
+    int sib[MAXN];   // 右兄弟
+    int prv[MAXN];
+    bool in[MAXN];
+    int root = 0;
+
+    // 合并两棵树，键大的根成为键小的根的最左孩子
+    int meld(int a, int b) {
+        if (a == 0) return b;
+        if (b == 0) return a;
+        if (key[b] < key[a]) {
+            int t = a;
+            a = b;
+            b = t;
+        }
+        sib[b] = child[a];
+        if (child[a] != 0) prv[child[a]] = b;
+        prv[b] = a;
+        child[a] = b;
+        return a;
+    }
+
+    void reset(int n) {
+        for (int i = 1; i <= n; ++i) {
+            child[i] = sib[i] = prv[i] = 0;
+            in[i] = false;
+        }
+        root = 0;
+    }
+
+    bool contains(int u) const { return in[u]; }
+    bool empty() const { return root == 0; }
+
+    void push(int u, int d) {
+        key[u] = d;
+        child[u] = sib[u] = prv[u] = 0;
+        in[u] = true;
+        root = meld(root, u);
+    }
+
+    void decrease(int u, int d) {
+        key[u] = d;
+        if (u == root) return;
+        // 把以 u 为根的子树从兄弟链上剪下来
+        int p = prv[u];
+        if (child[p] == u) child[p] = sib[u];
+        else sib[p] = sib[u];
+        if (sib[u] != 0) prv[sib[u]] = p;
+        sib[u] = prv[u] = 0;
+        root = meld(root, u);
+    }
+
+    HeapNode pop() {
+        int r = root;
+        HeapNode res = {r, key[r]};
+        in[r] = false;
+
+        // 第一趟：从左到右两两合并，结果用 sib 串成一个栈
+        int first = child[r];
+        int stack = 0;
+        while (first != 0) {
+            int a = first;
+            int b = sib[a];
+            if (b == 0) {
+                sib[a] = stack;
+                stack = a;
+                break;
+            }
+            first = sib[b];
+            sib[a] = sib[b] = 0;
+            int t = meld(a, b);
+            sib[t] = stack;
+            stack = t;
+        }
+        // 第二趟：从右到左（也就是出栈顺序）依次并入
+        int res_root = 0;
+        while (stack != 0) {
+            int next = sib[stack];
+            sib[stack] = 0;
+            res_root = meld(res_root, stack);
+            stack = next;
+        }
+        if (res_root != 0) prv[res_root] = 0;
+        root = res_root;
+        return res;
+    }
+};
+
+// ---- 2.3 基数堆 (只用于键单调的负载) ----
+// 要求：任何时候压入/改小后的键都不小于上一次弹出的键 last（键为非负 int）。
+// 键 d 放在第 bucket(d) 个桶里：d == last 放 0 号桶，否则放 d 与 last 的最高不同位 + 1 号桶。
+// 弹出时 0 号桶空了，就找第一个非空桶，取其中最小值作为新的 last，把这个桶整体重新分配，
+// 里面的元素只会落到更小号的桶里，每个元素一生最多移动 32 次，摊还 O(log C)。
+// 桶是以顶点为节点的双向链表，所以 decrease 只是从旧桶摘下、挂到新桶。
+struct RadixHeapPQ {
+    static const int BUCKETS = 33;
+    int key[MAXN];
+    int nxt[MAXN];
+    int prv[MAXN];
+    int bkt[MAXN]; // 所在桶号，-1 表示不在队列中
+    int first[BUCKETS];
+    int last = 0;
+    int count = 0;
+
+    int bucket_of(int d) const {
+        unsigned int x = (unsigned int)d ^ (unsigned int)last;
+        return x == 0 ? 0 : 32 - __builtin_clz(x);
+    }
+
+    void link(int u, int b) {
+        bkt[u] = b;
+        prv[u] = 0;
+        nxt[u] = first[b];
+        if (first[b] != 0) prv[first[b]] = u;
+        first[b] = u;
+    }
+
+    void unlink(int u) {
+        int b = bkt[u];
+        if (prv[u] != 0) nxt[prv[u]] = nxt[u];
+        else first[b] = nxt[u];
+        if (nxt[u] != 0) prv[nxt[u]] = prv[u];
+        bkt[u] = -1;
+    }
+
+    void reset(int n) {
+        for (int i = 1; i <= n; ++i) bkt[i] = -1;
+        for (int b = 0; b < BUCKETS; ++b) first[b] = 0;
+        last = 0;
+        count = 0;
+    }
+
+    bool contains(int u) const { return bkt[u] != -1; }
+    bool empty() const { return count == 0; }
+
+    void push(int u, int d) {
+        key[u] = d;
+        link(u, bucket_of(d));
+        count++;
+    }
+
+    void decrease(int u, int d) {
+        unlink(u);
+        key[u] = d;
+        link(u, bucket_of(d));
+    }
+
+    HeapNode pop() {
+        if (first[0] == 0) {
+            int b = 1;
+            while (first[b] == 0) b++;
+            int mn = first[b];
+            for (int u = nxt[mn]; u != 0; u = nxt[u]) {
+                if (key[u] < key[mn]) mn = u;
+            }
+            last = key[mn];
+            int u = first[b];
+            first[b] = 0;
+            while (u != 0) {
+                int next = nxt[u];
+                link(u, bucket_of(key[u]));
+                u = next;
+            }
+        }
+        int u = first[0];
+        unlink(u);
+        count--;
+        return {u, key[u]};
+    }
+};
 
 // ----------------------
 // 3. Prim 算法主逻辑
@@ -103,28 +342,28 @@ int n, m;
 int dis[MAXN];    // 存储节点到生成树的最小距离
 bool vis[MAXN];   // 标记节点是否已加入生成树
 
-long long prim() {
+template <class PQ>
+long long prim(PQ& pq) {
     // 初始化
     for (int i = 1; i <= n; ++i) {
         dis[i] = INF;
         vis[i] = false;
     }
+    pq.reset(n);
 
     long long total_weight = 0;
     int edges_count = 0; // 记录加入生成树的边的数量
 
     // 从节点1开始
     dis[1] = 0;
-    heap_push(1, 0);
+    pq.push(1, 0);
 
-    while (!heap_empty()) {
-        HeapNode top = heap_pop();
+    while (!pq.empty()) {
+        HeapNode top = pq.pop();
         int u = top.u;
         int d = top.d;
 
-        // 如果该点已经加入过生成树，跳过
-        if (vis[u]) continue;
-
+        // 队列里没有过期条目，弹出的点一定还没加入生成树
         // 将该点加入生成树
         vis[u] = true;
         total_weight += d;
@@ -138,7 +377,12 @@ long long prim() {
             // 如果 v 未访问，且新边权重小于 v 当前记录的最小距离
             if (!vis[v] && w < dis[v]) {
                 dis[v] = w;
-                heap_push(v, w); // 将更新后的距离加入堆
+                // 已在队列中就原地改小，否则第一次入队
+                if (pq.contains(v)) {
+                    pq.decrease(v, w);
+                } else {
+                    pq.push(v, w);
+                }
             }
         }
     }
@@ -149,7 +393,100 @@ long long prim() {
     return total_weight;
 }
 
-int main() {
+// ----------------------
+// 4. 性能测试
+// ----------------------
+// --bench N M：随机生成 N 个点、M 条边的连通图（边权 0~1000），
+// 分别用二叉堆、配对堆跑 Prim，再用三种引擎跑一遍 Dijkstra（键单调，基数堆适用），
+// 结果和耗时打印到 stderr
+
+// 从 1 号点出发的单源最短路，返回所有可达点的距离之和（用来核对各引擎结果一致）
+template <class PQ>
+long long dijkstra(PQ& pq) {
+    for (int i = 1; i <= n; ++i) {
+        dis[i] = INF;
+        vis[i] = false;
+    }
+    pq.reset(n);
+    dis[1] = 0;
+    pq.push(1, 0);
+    long long sum = 0;
+    while (!pq.empty()) {
+        HeapNode top = pq.pop();
+        int u = top.u;
+        vis[u] = true;
+        sum += top.d;
+        for (int i = head[u]; i != 0; i = edges[i].next) {
+            int v = edges[i].to;
+            int nd = top.d + edges[i].w;
+            if (!vis[v] && nd < dis[v]) {
+                dis[v] = nd;
+                if (pq.contains(v)) {
+                    pq.decrease(v, nd);
+                } else {
+                    pq.push(v, nd);
+                }
+            }
+        }
+    }
+    return sum;
+}
+
+template <class PQ>
+void bench_one(const char* name, const char* algo, PQ& pq, long long (*run)(PQ&)) {
+    auto t0 = std::chrono::steady_clock::now();
+    long long result = run(pq);
+    auto t1 = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    fprintf(stderr, "%-8s %-8s result=%lld  %.1f ms\n", algo, name, result, ms);
+}
+
+BinaryHeapPQ binary_pq;
+PairingHeapPQ pairing_pq;
+RadixHeapPQ radix_pq;
+
+void run_bench(int bn, int bm) {
+    if (bn < 1) bn = 1;
+    if (bn > MAXN - 1) bn = MAXN - 1;
+    if (bm < bn - 1) bm = bn - 1;
+    if (bm > (MAXM - 1) / 2) bm = (MAXM - 1) / 2;
+    n = bn;
+    m = bm;
+    unsigned int seed = 20240607;
+    auto rnd = [&]() {
+        seed = seed * 1103515245u + 12345u;
+        return seed >> 8;
+    };
+    // 先连一棵随机树保证连通，剩下的边随机加
+    for (int i = 2; i <= n; ++i) {
+        int u = (int)(rnd() % (unsigned int)(i - 1)) + 1;
+        int w = (int)(rnd() % 1001);
+        add_edge(u, i, w);
+        add_edge(i, u, w);
+    }
+    for (int i = n - 1; i < m; ++i) {
+        int u = (int)(rnd() % (unsigned int)n) + 1;
+        int v = (int)(rnd() % (unsigned int)n) + 1;
+        int w = (int)(rnd() % 1001);
+        add_edge(u, v, w);
+        add_edge(v, u, w);
+    }
+
+    bench_one("binary", "prim", binary_pq, prim<BinaryHeapPQ>);
+    bench_one("pairing", "prim", pairing_pq, prim<PairingHeapPQ>);
+    bench_one("binary", "dijkstra", binary_pq, dijkstra<BinaryHeapPQ>);
+    bench_one("pairing", "dijkstra", pairing_pq, dijkstra<PairingHeapPQ>);
+    bench_one("radix", "dijkstra", radix_pq, dijkstra<RadixHeapPQ>);
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i + 2 < argc; ++i) {
+        if (strcmp(argv[i], "--bench") == 0) {
+            run_bench(atoi(argv[i + 1]), atoi(argv[i + 2]));
+            return 0;
+        }
+    }
+
     // 提高读写速度，虽然这里不是瓶颈
     std::ios::sync_with_stdio(false);
     std::cin.tie(NULL);
@@ -165,7 +502,11 @@ int main() {
         add_edge(v, u, w);
     }
 
-    std::cout << prim() << std::endl;
+#if PRIM_HEAP == PRIM_HEAP_PAIRING
+    std::cout << prim(pairing_pq) << std::endl;
+#else
+    std::cout << prim(binary_pq) << std::endl;
+#endif
 
     return 0;
-}
\ No newline at end of file
+}